@@ -1,7 +1,24 @@
 #include <gtest/gtest.h>
 #include "dijkstras.h"
 #include "ladder.h"
+#include "shortest_path_tree.h"
+#include "generators.h"
+#include "dijkstra_engine.h"
+#include "ladder_dag.h"
+#include "bk_tree.h"
 #include <sstream>
+#include <random>
+#include <numeric>
+#include <functional>
+
+// Runs check once per name, with the name attached to any failure it
+// reports.
+static void for_each_name(initializer_list<const char*> names, const function<void(const string&)>& check) {
+    for (const char* name : names) {
+        SCOPED_TRACE(name);
+        check(name);
+    }
+}
 
 class DijkstraTest : public ::testing::Test {
 protected:
@@ -104,6 +121,670 @@ TEST_F(DijkstraTest, NegativeEdgeWeightsTest) {
     EXPECT_EQ(distances[2], -1);
 }
 
+static Graph random_graph(int n, int m, int max_weight, unsigned seed) {
+    mt19937 rng(seed);
+    Graph G;
+    G.resize(n);
+    for (int i = 0; i < m; ++i) {
+        int src = rng() % n;
+        G[src].push_back(Edge(rng() % n, rng() % (max_weight + 1)));
+    }
+    return G;
+}
+
+TEST_F(DijkstraTest, BucketQueueMatchesBinaryHeapTest) {
+    for (unsigned seed = 0; seed < 20; ++seed) {
+        // Odd seeds have no zero weights, which drains buckets in FIFO order.
+        Graph G = random_graph(200, 1000 + 100 * seed, seed % 4 == 0 ? 1 : 20, seed);
+        for (int u = 0; seed % 2 == 1 && u < G.numVertices; ++u) {
+            for (Edge& edge : G[u]) {
+                edge.weight += 1;
+            }
+        }
+        for (int source : {0, 7, 199}) {
+            vector<int> heap_previous, bucket_previous;
+            vector<int> heap_distances = dijkstra_shortest_path(G, source, heap_previous, DijkstraQueue::BinaryHeap);
+            vector<int> bucket_distances = dijkstra_shortest_path(G, source, bucket_previous, DijkstraQueue::Buckets);
+            EXPECT_EQ(heap_distances, bucket_distances);
+            EXPECT_EQ(heap_previous, bucket_previous);
+        }
+    }
+    
+    for_each_name({"small.txt", "medium.txt", "large.txt", "largest.txt"}, [&](const string& file) {
+        Graph G;
+        file_to_graph(file, G);
+        vector<int> heap_previous, bucket_previous;
+        EXPECT_EQ(dijkstra_shortest_path(G, 0, heap_previous), dijkstra_shortest_path(G, 0, bucket_previous, DijkstraQueue::Buckets));
+        EXPECT_EQ(heap_previous, bucket_previous);
+    });
+}
+
+TEST_F(DijkstraTest, BucketQueueLargeWeightsTest) {
+    // Weights above the cap fall back to the heap; sums past INF saturate.
+    for (int weight : {MAX_BUCKET_WEIGHT, MAX_BUCKET_WEIGHT + 1, INF - 5}) {
+        Graph G;
+        G.resize(4);
+        G.add_edge(0, 1, weight);
+        G.add_edge(1, 2, weight);
+        G.add_edge(0, 3, 2);
+        G.add_edge(3, 2, 1);
+        vector<int> heap_previous, bucket_previous;
+        EXPECT_EQ(dijkstra_shortest_path(G, 0, bucket_previous, DijkstraQueue::Buckets), dijkstra_shortest_path(G, 0, heap_previous)) << weight;
+        EXPECT_EQ(bucket_previous, heap_previous) << weight;
+    }
+    
+    Graph G;
+    G.resize(3);
+    G.add_edge(0, 1, MAX_BUCKET_WEIGHT);
+    G.add_edge(1, 2, MAX_BUCKET_WEIGHT);
+    DijkstraWorkspace workspace;
+    dijkstra_shortest_path(G, 0, workspace, DijkstraQueue::Buckets);
+    EXPECT_EQ(workspace.distance(2), 2 * MAX_BUCKET_WEIGHT);
+    EXPECT_EQ(workspace.buckets.size(), size_t(MAX_BUCKET_WEIGHT) + 1);
+}
+
+TEST_F(DijkstraTest, BucketQueueRejectsNegativeWeightsTest) {
+    std::stringstream ss("3\n0 1 2\n1 2 -3\n");
+    Graph G;
+    ss >> G;
+    
+    vector<int> previous;
+    EXPECT_THROW(dijkstra_shortest_path(G, 0, previous, DijkstraQueue::Buckets), invalid_argument);
+}
+
+TEST_F(DijkstraTest, CsrGraphMatchesAdjacencyListTest) {
+    Graph G = createSimpleGraph();
+    CsrGraph csr(G);
+    ASSERT_EQ(csr.numVertices, 4);
+    ASSERT_EQ(csr.numEdges(), 5);
+    EXPECT_EQ(csr.offsets, vector<int>({0, 2, 3, 5, 5}));
+    EXPECT_EQ(csr.dsts, vector<int>({1, 2, 3, 1, 3}));
+    EXPECT_EQ(csr.weights, vector<int>({5, 3, 2, 1, 6}));
+    
+    for_each_name({"small.txt", "medium.txt", "large.txt", "largest.txt"}, [&](const string& file) {
+        Graph list_graph;
+        CsrGraph loaded;
+        file_to_graph(file, list_graph);
+        file_to_graph(file, loaded);
+        CsrGraph converted(list_graph);
+        EXPECT_EQ(loaded.offsets, converted.offsets);
+        EXPECT_EQ(loaded.dsts, converted.dsts);
+        EXPECT_EQ(loaded.weights, converted.weights);
+        
+        for (DijkstraQueue queue : {DijkstraQueue::BinaryHeap, DijkstraQueue::Buckets}) {
+            vector<int> list_previous, csr_previous;
+            EXPECT_EQ(dijkstra_shortest_path(list_graph, 0, list_previous, queue), dijkstra_shortest_path(loaded, 0, csr_previous, queue));
+            EXPECT_EQ(list_previous, csr_previous);
+        }
+    });
+}
+
+TEST_F(DijkstraTest, TextLoaderMatchesStreamParseTest) {
+    for_each_name({"small.txt", "medium.txt", "large.txt", "largest.txt"}, [&](const string& file) {
+        ifstream in(file);
+        Graph streamed;
+        in >> streamed;
+        
+        Graph loaded;
+        file_to_graph(file, loaded);
+        ASSERT_EQ(loaded.numVertices, streamed.numVertices);
+        for (int u = 0; u < loaded.numVertices; ++u) {
+            ASSERT_EQ(loaded[u].size(), streamed[u].size());
+            for (size_t i = 0; i < loaded[u].size(); ++i) {
+                EXPECT_EQ(loaded[u][i].dst, streamed[u][i].dst);
+                EXPECT_EQ(loaded[u][i].weight, streamed[u][i].weight);
+            }
+        }
+    });
+    
+    string text = "3\n\n0 1 -4\r\n  2 0 7\n";
+    CsrGraph G;
+    parse_graph_text(text.data(), text.size(), "inline", G);
+    EXPECT_EQ(G.offsets, vector<int>({0, 1, 1, 2}));
+    EXPECT_EQ(G.dsts, vector<int>({1, 0}));
+    EXPECT_EQ(G.weights, vector<int>({-4, 7}));
+}
+
+TEST_F(DijkstraTest, TextLoaderReportsMalformedLinesTest) {
+    auto error_for = [](const string& text) {
+        Graph G;
+        try {
+            parse_graph_text(text.data(), text.size(), "bad.txt", G);
+        } catch (const runtime_error& e) {
+            return string(e.what());
+        }
+        return string();
+    };
+    
+    EXPECT_EQ(error_for(""), "bad.txt:1: missing vertex count");
+    EXPECT_EQ(error_for("3\n0 1 2\n1 x 2\n"), "bad.txt:3: expected destination vertex");
+    EXPECT_EQ(error_for("3\n0 1 2\n\n1 2\n"), "bad.txt:4: expected edge weight");
+    EXPECT_EQ(error_for("3\n0 1 2 9\n"), "bad.txt:2: unexpected trailing characters");
+    EXPECT_EQ(error_for("3\n0 3 2\n"), "bad.txt:2: vertex out of range [0, 3)");
+    EXPECT_EQ(error_for("3\n0 1 99999999999\n"), "bad.txt:2: edge weight out of range");
+    EXPECT_THROW(MappedFile("does_not_exist.txt"), runtime_error);
+}
+
+TEST_F(DijkstraTest, BinaryGraphRoundTripTest) {
+    const string binary_file = "largest.test.bin";
+    CsrGraph G;
+    file_to_graph("largest.txt", G);
+    save_graph_binary(G, binary_file);
+    EXPECT_TRUE(is_graph_binary(binary_file));
+    EXPECT_FALSE(is_graph_binary("largest.txt"));
+    
+    {
+        MappedGraph mapped(binary_file);
+        ASSERT_EQ(mapped.numVertices, G.numVertices);
+        ASSERT_EQ(mapped.numEdges(), G.numEdges());
+        EXPECT_TRUE(equal(G.offsets.begin(), G.offsets.end(), mapped.offsets));
+        EXPECT_TRUE(equal(G.dsts.begin(), G.dsts.end(), mapped.dsts));
+        EXPECT_TRUE(equal(G.weights.begin(), G.weights.end(), mapped.weights));
+        
+        vector<int> csr_previous, mapped_previous;
+        EXPECT_EQ(dijkstra_shortest_path(G, 0, csr_previous), dijkstra_shortest_path(mapped, 0, mapped_previous));
+        EXPECT_EQ(csr_previous, mapped_previous);
+    }
+    
+    {
+        fstream corrupt(binary_file, ios::in | ios::out | ios::binary);
+        corrupt.seekp(sizeof(GraphBinaryHeader) + sizeof(int));
+        int bad_offset = -5;
+        corrupt.write(reinterpret_cast<const char*>(&bad_offset), sizeof(bad_offset));
+    }
+    EXPECT_THROW(MappedGraph mapped(binary_file), runtime_error);
+    EXPECT_THROW(MappedGraph mapped("largest.txt"), runtime_error);
+    remove(binary_file.c_str());
+}
+
+TEST_F(DijkstraTest, MultiSourceMatchesSingleRunsTest) {
+    Graph G = random_graph(150, 900, 30, 11);
+    vector<int> sources = {0, 149, 3, 3, 77};
+    DistanceMatrix matrix = multi_source_shortest_paths(G, sources, 3);
+    ASSERT_EQ(matrix.sources, sources);
+    ASSERT_EQ(matrix.distances.size(), sources.size() * 150);
+    for (size_t i = 0; i < sources.size(); ++i) {
+        vector<int> previous;
+        vector<int> expected = dijkstra_shortest_path(G, sources[i], previous);
+        span<const int> row = matrix.row(i);
+        EXPECT_EQ(vector<int>(row.begin(), row.end()), expected);
+    }
+    
+    CsrGraph csr;
+    file_to_graph("largest.txt", csr);
+    DistanceMatrix all_pairs = all_pairs_shortest_paths(csr, 4);
+    ASSERT_EQ(all_pairs.sources.size(), csr.numVertices);
+    for (int source = 0; source < csr.numVertices; source += 13) {
+        vector<int> previous;
+        vector<int> expected = dijkstra_shortest_path(csr, source, previous);
+        for (int v = 0; v < csr.numVertices; ++v) {
+            EXPECT_EQ(all_pairs.at(source, v), expected[v]);
+        }
+    }
+}
+
+static Graph grid_graph(int side, int max_weight, unsigned seed) {
+    mt19937 rng(seed);
+    Graph G;
+    G.resize(side * side);
+    for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+            int u = r * side + c;
+            if (c + 1 < side) {
+                G[u].push_back(Edge(u + 1, 1 + rng() % max_weight));
+                G[u + 1].push_back(Edge(u, 1 + rng() % max_weight));
+            }
+            if (r + 1 < side) {
+                G[u].push_back(Edge(u + side, 1 + rng() % max_weight));
+                G[u + side].push_back(Edge(u, 1 + rng() % max_weight));
+            }
+        }
+    }
+    return G;
+}
+
+TEST_F(DijkstraTest, PointToPointMatchesFullRunTest) {
+    for (const Graph& G : {random_graph(300, 1200, 25, 5), grid_graph(30, 9, 6)}) {
+        Landmarks landmarks = select_landmarks(G, 4, 2);
+        ASSERT_EQ(landmarks.vertices.size(), 4);
+        
+        mt19937 rng(7);
+        DijkstraWorkspace workspace;
+        int plain_settled = 0, alt_settled = 0;
+        for (int query = 0; query < 40; ++query) {
+            int source = rng() % G.numVertices;
+            int target = rng() % G.numVertices;
+            vector<int> previous;
+            vector<int> distances = dijkstra_shortest_path(G, source, previous);
+            
+            PointToPointResult plain = dijkstra_point_to_point(G, source, target);
+            PointToPointResult alt = dijkstra_point_to_point(G, source, target, &landmarks);
+            EXPECT_EQ(plain.cost, distances[target]);
+            EXPECT_EQ(alt.cost, distances[target]);
+            PointToPointResult reused = dijkstra_point_to_point(G, source, target, workspace, &landmarks);
+            EXPECT_EQ(reused.path, alt.path);
+            EXPECT_EQ(reused.settled, alt.settled);
+            plain_settled += plain.settled;
+            alt_settled += alt.settled;
+            
+            for (const PointToPointResult& result : {plain, alt}) {
+                if (result.cost == INF) {
+                    EXPECT_TRUE(result.path.empty());
+                    continue;
+                }
+                ASSERT_FALSE(result.path.empty());
+                EXPECT_EQ(result.path.front(), source);
+                EXPECT_EQ(result.path.back(), target);
+                int total = 0;
+                for (size_t i = 1; i < result.path.size(); ++i) {
+                    int best = INF;
+                    for (const Edge& edge : G[result.path[i - 1]]) {
+                        if (edge.dst == result.path[i]) {
+                            best = min(best, edge.weight);
+                        }
+                    }
+                    ASSERT_NE(best, INF);
+                    total += best;
+                }
+                EXPECT_EQ(total, result.cost);
+            }
+        }
+        EXPECT_LE(alt_settled, plain_settled);
+    }
+}
+
+TEST_F(DijkstraTest, ShortestPathTreeIncrementalUpdatesTest) {
+    for (unsigned seed = 0; seed < 6; ++seed) {
+        mt19937 rng(seed);
+        Graph G = random_graph(120, 400, 12, seed + 100);
+        for (int u = 0; u < G.numVertices; ++u) {
+            for (Edge& edge : G[u]) {
+                edge.weight += 1;
+            }
+        }
+        ShortestPathTree tree(G, seed % 5);
+        
+        for (int step = 0; step < 150; ++step) {
+            int src = rng() % G.numVertices;
+            if (rng() % 3 == 0 || tree.graph()[src].empty()) {
+                tree.insert_edge(src, rng() % G.numVertices, 1 + rng() % 15);
+            } else {
+                const Edge& edge = tree.graph()[src][rng() % tree.graph()[src].size()];
+                tree.update_edge_weight(src, edge.dst, 1 + rng() % 15);
+            }
+            
+            vector<int> previous;
+            vector<int> distances = dijkstra_shortest_path(tree.graph(), tree.source(), previous);
+            ASSERT_EQ(tree.distances(), distances) << "seed " << seed << " step " << step;
+            ASSERT_EQ(tree.previous(), previous) << "seed " << seed << " step " << step;
+        }
+    }
+}
+
+TEST_F(DijkstraTest, ShortestPathTreeLocalUpdateTest) {
+    Graph G = grid_graph(40, 9, 3);
+    ShortestPathTree tree(G, 0);
+    
+    int far = G.numVertices - 1;
+    const Edge& edge = tree.graph()[far][0];
+    tree.update_edge_weight(far, edge.dst, edge.weight + 5);
+    EXPECT_LT(tree.last_update_size(), 50);
+    
+    EXPECT_THROW(tree.insert_edge(0, 1, 0), invalid_argument);
+    EXPECT_THROW(tree.update_edge_weight(0, far, 3), invalid_argument);
+}
+
+TEST_F(DijkstraTest, ShortestPathTreeNearOverflowTest) {
+    Graph G;
+    G.resize(4);
+    G.add_edge(0, 1, INF - 10);
+    G.add_edge(1, 2, 20);
+    G.add_edge(0, 3, INF - 3);
+    G.add_edge(3, 2, 1);
+    ShortestPathTree tree(G, 0);
+    
+    auto matches_dijkstra = [&]() {
+        vector<int> previous;
+        vector<int> distances = dijkstra_shortest_path(tree.graph(), tree.source(), previous);
+        EXPECT_EQ(tree.distances(), distances);
+        EXPECT_EQ(tree.previous(), previous);
+    };
+    
+    // Sums past INT_MAX stay unreachable instead of wrapping negative.
+    matches_dijkstra();
+    EXPECT_EQ(tree.distances()[2], INF - 2);
+    tree.update_edge_weight(1, 2, 5);
+    matches_dijkstra();
+    EXPECT_EQ(tree.previous()[2], 1);
+    tree.update_edge_weight(1, 2, 30);
+    matches_dijkstra();
+    EXPECT_EQ(tree.previous()[2], 3);
+    tree.insert_edge(1, 3, 100);
+    matches_dijkstra();
+    tree.insert_edge(2, 0, 50);
+    matches_dijkstra();
+    tree.update_edge_weight(0, 3, INF - 1);
+    matches_dijkstra();
+    EXPECT_EQ(tree.distances()[2], INF);
+}
+
+TEST_F(DijkstraTest, DeltaSteppingMatchesDijkstraTest) {
+    vector<Graph> graphs = {random_graph(400, 3000, 50, 21), random_graph(300, 900, 0, 22), grid_graph(25, 20, 23)};
+    Graph largest;
+    file_to_graph("largest.txt", largest);
+    graphs.push_back(largest);
+    
+    for (const Graph& G : graphs) {
+        vector<int> expected_previous;
+        vector<int> expected = dijkstra_shortest_path(G, 0, expected_previous);
+        
+        for (int delta : {0, 1, 7, 1000}) {
+            for (int threads : {1, 4}) {
+                vector<int> previous;
+                vector<int> distances = delta_stepping_shortest_path(G, 0, previous, delta, threads);
+                ASSERT_EQ(distances, expected) << "delta " << delta << " threads " << threads;
+                
+                for (int v = 0; v < G.numVertices; ++v) {
+                    if (v == 0 || distances[v] == INF) {
+                        EXPECT_EQ(previous[v], -1);
+                        continue;
+                    }
+                    int u = previous[v];
+                    ASSERT_GE(u, 0);
+                    bool tight = false;
+                    for (const Edge& edge : G[u]) {
+                        tight = tight || (edge.dst == v && distances[u] + edge.weight == distances[v]);
+                    }
+                    EXPECT_TRUE(tight) << u << " -> " << v;
+                }
+                vector<int> path = extract_shortest_path(distances, previous, G.numVertices - 1);
+                EXPECT_TRUE(path.empty() || path.front() == 0);
+            }
+        }
+    }
+    
+    // Paths that overflow int stay unreachable rather than wrapping.
+    Graph huge;
+    huge.resize(3);
+    huge.add_edge(0, 1, INF - 5);
+    huge.add_edge(1, 2, 10);
+    for (int threads : {1, 4}) {
+        vector<int> previous;
+        EXPECT_EQ(delta_stepping_shortest_path(huge, 0, previous, 0, threads), vector<int>({0, INF - 5, INF}));
+        EXPECT_EQ(previous, vector<int>({-1, 0, -1}));
+    }
+    
+    // One heavy edge with delta 1 must not size a bucket per unit of weight.
+    Graph heavy;
+    heavy.resize(4);
+    heavy.add_edge(0, 1, 1000000000);
+    heavy.add_edge(0, 2, 1);
+    heavy.add_edge(2, 3, 2);
+    heavy.add_edge(3, 1, 4);
+    for (int threads : {1, 4}) {
+        vector<int> previous;
+        EXPECT_EQ(delta_stepping_shortest_path(heavy, 0, previous, 1, threads), vector<int>({0, 7, 1, 3}));
+        EXPECT_EQ(previous, vector<int>({-1, 3, 0, 2}));
+    }
+}
+
+TEST_F(DijkstraTest, GeneratedGraphsRoundTripTest) {
+    CsrGraph grid = generate_grid_graph(10, 9, 3);
+    EXPECT_EQ(grid.numVertices, 100);
+    EXPECT_EQ(grid.numEdges(), 4 * 10 * 9);
+    
+    CsrGraph power_law = generate_power_law_graph(200, 3, 9, 5);
+    EXPECT_EQ(power_law.numEdges(), 2 * (1 + 2 + 3 * 197));
+    
+    CsrGraph random = generate_random_graph(50, 400, 9, 7);
+    CsrGraph again = generate_random_graph(50, 400, 9, 7);
+    EXPECT_EQ(random.offsets, again.offsets);
+    EXPECT_EQ(random.dsts, again.dsts);
+    EXPECT_EQ(random.weights, again.weights);
+    
+    string filename = testing::TempDir() + "generated_graph.txt";
+    write_graph_text(random, filename);
+    CsrGraph loaded;
+    file_to_graph(filename, loaded);
+    remove(filename.c_str());
+    EXPECT_EQ(loaded.offsets, random.offsets);
+    EXPECT_EQ(loaded.dsts, random.dsts);
+    EXPECT_EQ(loaded.weights, random.weights);
+}
+
+TEST_F(DijkstraTest, SearchStatsCountersTest) {
+    Graph G = random_graph(300, 2000, 20, 21);
+    for (DijkstraQueue queue : {DijkstraQueue::BinaryHeap, DijkstraQueue::Buckets}) {
+        vector<int> expected_previous, previous;
+        vector<int> expected = dijkstra_shortest_path(G, 0, expected_previous, queue);
+        SearchStats stats;
+        EXPECT_EQ(dijkstra_shortest_path(G, 0, previous, stats, queue), expected);
+        EXPECT_EQ(previous, expected_previous);
+        
+        long long reachable = count_if(expected.begin(), expected.end(), [](int d) { return d != INF; });
+        long long out_edges = 0;
+        for (int u = 0; u < G.numVertices; ++u) {
+            out_edges += expected[u] != INF ? G[u].size() : 0;
+        }
+        EXPECT_EQ(stats.nodes_settled, reachable);
+        EXPECT_EQ(stats.edges_relaxed, out_edges);
+        EXPECT_EQ(stats.pushes, stats.pops);
+        EXPECT_EQ(stats.pops - stats.stale_pops, stats.nodes_settled);
+        EXPECT_EQ(stats.pushes, stats.distance_updates + 1);
+        EXPECT_GE(stats.peak_frontier, 1);
+        EXPECT_GE(stats.search_ms, 0);
+    }
+}
+
+TEST_F(DijkstraTest, StreamedPathsMatchExtractTest) {
+    Graph G = random_graph(200, 600, 9, 31);
+    vector<int> previous;
+    vector<int> distances = dijkstra_shortest_path(G, 0, previous);
+    
+    string filename = testing::TempDir() + "streamed_paths";
+    for (PathFormat format : {PathFormat::Text, PathFormat::Csv, PathFormat::Binary}) {
+        {
+            OutputBuffer out(filename, 64);
+            for (int v = 0; v < G.numVertices; ++v) {
+                write_shortest_path(out, distances, previous, 0, v, format);
+            }
+        }
+        ifstream in(filename, ios::binary);
+        string written((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        
+        string expected;
+        for (int v = 0; v < G.numVertices; ++v) {
+            vector<int> path = extract_shortest_path(distances, previous, v);
+            if (format == PathFormat::Binary) {
+                int32_t header[4] = {0, v, distances[v], static_cast<int32_t>(path.size())};
+                expected.append(reinterpret_cast<const char*>(header), sizeof(header));
+                expected.append(reinterpret_cast<const char*>(path.data()), path.size() * sizeof(int));
+                continue;
+            }
+            if (format == PathFormat::Csv) {
+                expected += "0," + to_string(v) + "," + (path.empty() ? "" : to_string(distances[v])) + ",";
+            }
+            for (size_t i = 0; i < path.size(); ++i) {
+                expected += to_string(path[i]);
+                if (format == PathFormat::Text || i + 1 < path.size()) {
+                    expected += " ";
+                }
+            }
+            if (format == PathFormat::Text) {
+                expected += "\nTotal cost is " + to_string(distances[v]);
+            }
+            expected += "\n";
+        }
+        EXPECT_EQ(written, expected) << static_cast<int>(format);
+    }
+    remove(filename.c_str());
+}
+
+TEST_F(DijkstraTest, WeightTypeInstantiationsTest) {
+    Graph G = random_graph(400, 3000, 60000, 41);
+    vector<int> expected_previous;
+    vector<int> expected = dijkstra_shortest_path(G, 0, expected_previous);
+    
+    vector<int> previous;
+    vector<int> narrow = basic_dijkstra_shortest_path(BasicCsrGraph<uint16_t>(G), 0, previous);
+    EXPECT_EQ(narrow, expected);
+    EXPECT_EQ(previous, expected_previous);
+    
+    vector<int64_t> wide = basic_dijkstra_shortest_path(BasicGraph<int64_t>(G), 0, previous);
+    EXPECT_EQ(previous, expected_previous);
+    for (int v = 0; v < G.numVertices; ++v) {
+        EXPECT_EQ(wide[v], expected[v] == INF ? numeric_limits<int64_t>::max() : expected[v]);
+    }
+    
+    vector<double> real = basic_dijkstra_shortest_path(BasicCsrGraph<double>(G), 0, previous);
+    EXPECT_EQ(previous, expected_previous);
+    for (int v = 0; v < G.numVertices; ++v) {
+        EXPECT_EQ(real[v], expected[v] == INF ? numeric_limits<double>::infinity() : expected[v]);
+    }
+    
+    EXPECT_THROW(BasicCsrGraph<uint8_t>{G}, out_of_range);
+}
+
+TEST_F(DijkstraTest, SaturatingDistancesTest) {
+    // 0 -> 1 -> 2 costs 2 * 2e9, past int but well inside int64_t.
+    BasicGraph<int64_t> wide;
+    wide.resize(3);
+    wide[0].emplace_back(1, 2000000000);
+    wide[1].emplace_back(2, 2000000000);
+    vector<int> previous;
+    EXPECT_EQ(basic_dijkstra_shortest_path(wide, 0, previous)[2], 4000000000LL);
+    
+    // In int the same path overflows, so it saturates to unreachable.
+    Graph narrow;
+    narrow.resize(3);
+    narrow[0].push_back(Edge(1, 2000000000));
+    narrow[1].push_back(Edge(2, 2000000000));
+    vector<int> distances = dijkstra_shortest_path(narrow, 0, previous);
+    EXPECT_EQ(distances[1], 2000000000);
+    EXPECT_EQ(distances[2], INF);
+    EXPECT_EQ(previous[2], -1);
+    EXPECT_EQ(saturating_add(INF, 5), INF);
+    EXPECT_EQ(saturating_add<uint32_t>(numeric_limits<uint32_t>::max() - 1, 3u), numeric_limits<uint32_t>::max());
+}
+
+TEST_F(DijkstraTest, IndexedHeapMatchesBinaryHeapTest) {
+    for (unsigned seed = 0; seed < 4; ++seed) {
+        Graph G = seed % 2 ? random_graph(300, 6000, 50, seed) : grid_graph(15, 9, seed);
+        vector<int> expected_previous, previous;
+        vector<int> expected = dijkstra_shortest_path(G, 0, expected_previous);
+        
+        SearchStats stats;
+        EXPECT_EQ(dijkstra_shortest_path(G, 0, previous, stats, DijkstraQueue::IndexedHeap), expected);
+        EXPECT_EQ(previous, expected_previous);
+        EXPECT_EQ(stats.stale_pops, 0);
+        EXPECT_EQ(stats.pops, stats.nodes_settled);
+        EXPECT_LE(stats.peak_frontier, G.numVertices);
+    }
+    
+    // Pushes with random decrease-keys against a sorted reference.
+    mt19937 rng(5);
+    IndexedQuaternaryHeap<int> heap;
+    heap.reset(500);
+    vector<int> key(500, INF);
+    for (int i = 0; i < 3000; ++i) {
+        int v = rng() % 500;
+        int k = rng() % 1000;
+        if (k < key[v]) {
+            key[v] = k;
+            heap.push(v, k);
+        }
+    }
+    vector<pair<int, int>> expected;
+    for (int v = 0; v < 500; ++v) {
+        if (key[v] != INF) {
+            expected.push_back({key[v], v});
+        }
+    }
+    sort(expected.begin(), expected.end());
+    EXPECT_EQ(heap.size(), expected.size());
+    for (const auto& entry : expected) {
+        ASSERT_FALSE(heap.empty());
+        EXPECT_EQ(heap.pop(), entry);
+    }
+    EXPECT_TRUE(heap.empty());
+}
+
+TEST_F(DijkstraTest, WorkspaceReuseMatchesOneShotTest) {
+    // Graphs of different sizes through one workspace, every queue policy.
+    vector<Graph> graphs = {random_graph(300, 6000, 50, 1), grid_graph(8, 9, 2), random_graph(500, 4000, 20, 3), createDisconnectedGraph()};
+    DijkstraWorkspace workspace;
+    for (DijkstraQueue queue : {DijkstraQueue::BinaryHeap, DijkstraQueue::Buckets, DijkstraQueue::IndexedHeap}) {
+        for (int round = 0; round < 3; ++round) {
+            for (const Graph& G : graphs) {
+                int source = round % G.numVertices;
+                vector<int> expected_previous;
+                vector<int> expected = dijkstra_shortest_path(G, source, expected_previous, queue);
+                dijkstra_shortest_path(CsrGraph(G), source, workspace, queue);
+                for (int v = 0; v < G.numVertices; ++v) {
+                    ASSERT_EQ(workspace.distance(v), expected[v]) << v;
+                    ASSERT_EQ(workspace.previous(v), expected_previous[v]) << v;
+                }
+            }
+        }
+    }
+    
+    // An abandoned indexed heap is clean after reset.
+    IndexedQuaternaryHeap<int> heap;
+    heap.reset(10);
+    heap.push(3, 7);
+    heap.push(5, 2);
+    heap.reset(10);
+    EXPECT_TRUE(heap.empty());
+    heap.push(3, 4);
+    heap.push(3, 1);
+    EXPECT_EQ(heap.size(), 1u);
+    EXPECT_EQ(heap.pop(), make_pair(1, 3));
+}
+
+TEST_F(DijkstraTest, ArenaGraphCopyAndMoveTest) {
+    auto edges_of = [](const Graph& G) {
+        vector<vector<pair<int, int>>> edges(G.numVertices);
+        for (int u = 0; u < G.numVertices; ++u) {
+            for (const Edge& edge : G[u]) {
+                edges[u].push_back({edge.dst, edge.weight});
+            }
+        }
+        return edges;
+    };
+
+    // Lists grown one edge at a time recycle each other's old buffers.
+    Graph G = random_graph(400, 20000, 30, 9);
+    auto expected = edges_of(G);
+    EXPECT_EQ(G.numEdges(), 20000);
+
+    Graph copy(G);
+    EXPECT_EQ(edges_of(copy), expected);
+    copy.add_edge(0, 1, 7);
+    copy[5].clear();
+    EXPECT_EQ(edges_of(G), expected);
+
+    Graph moved(std::move(G));
+    EXPECT_EQ(G.numVertices, 0);
+    EXPECT_EQ(edges_of(moved), expected);
+    G = moved;
+    G.resize(450);
+    G.add_edge(449, 0, 3);
+    EXPECT_EQ(moved.numVertices, 400);
+    EXPECT_EQ(G.numEdges(), 20001);
+    moved = std::move(copy);
+    EXPECT_EQ(moved.numEdges(), 20001 - static_cast<long long>(expected[5].size()));
+
+    // The sized single-block load and incremental stream parsing agree.
+    for_each_name({"small.txt", "large.txt"}, [&](const string& file) {
+        Graph loaded;
+        file_to_graph(file, loaded);
+        Graph streamed;
+        ifstream in(file);
+        in >> streamed;
+        EXPECT_EQ(edges_of(loaded), edges_of(streamed));
+    });
+}
+
 class LadderTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -156,6 +837,17 @@ TEST_F(LadderTest, NonDictionaryStartWordTest) {
     }
 }
 
+TEST_F(LadderTest, SetOverloadFollowsWordListChangesTest) {
+    // Same size, different words: the cached graph must not be reused.
+    set<string> words = {"cat", "cot", "cog", "dog"};
+    EXPECT_EQ(generate_word_ladder("cat", "dog", words), vector<string>({"cat", "cot", "cog", "dog"}));
+    words = {"cat", "cag", "cog", "dog"};
+    EXPECT_EQ(generate_word_ladder("cat", "dog", words), vector<string>({"cat", "cag", "cog", "dog"}));
+    words.erase("cag");
+    EXPECT_TRUE(generate_word_ladder("cat", "dog", words).empty());
+    EXPECT_EQ(generate_word_ladder("cat", "dog", word_list).size(), 4);
+}
+
 TEST_F(LadderTest, EditDistanceTest) {
     EXPECT_TRUE(edit_distance_within("cat", "cot", 1));
     EXPECT_TRUE(edit_distance_within("cat", "cats", 1));
@@ -188,7 +880,427 @@ TEST_F(LadderTest, CaseInsensitiveTest) {
     EXPECT_EQ(ladder1.size(), ladder2.size());
 }
 
-int main(int argc, char **argv) {
-    ::testing::InitGoogleTest(&argc, argv);
-    return RUN_ALL_TESTS();
-}
\ No newline at end of file
+TEST_F(LadderTest, WordGraphMatchesBruteForceTest) {
+    WordGraph graph(word_list);
+    
+    for_each_name({"cat", "chat", "code", "awake", "marty", "zzzq"}, [&](const string& word) {
+        vector<int> expected;
+        for (const string& candidate : word_list) {
+            if (candidate != word && is_adjacent(word, candidate)) {
+                expected.push_back(graph.find(candidate));
+            }
+        }
+        sort(expected.begin(), expected.end());
+        EXPECT_EQ(graph.neighbors_of(word), expected);
+        
+        int word_id = graph.find(word);
+        if (word_id != -1) {
+            span<const int> neighbors = graph.neighbors(word_id);
+            EXPECT_EQ(vector<int>(neighbors.begin(), neighbors.end()), expected);
+        }
+    });
+}
+
+TEST_F(LadderTest, WordGraphLadderTest) {
+    WordGraph graph(word_list);
+    
+    EXPECT_EQ(generate_word_ladder("cat", "dog", graph), generate_word_ladder("cat", "dog", word_list));
+    EXPECT_EQ(generate_word_ladder("marty", "curls", graph).size(), 6);
+    EXPECT_EQ(generate_word_ladder("sleep", "awake", graph).size(), 8);
+}
+
+TEST_F(LadderTest, BidirectionalMatchesForwardLengthTest) {
+    WordGraph graph(word_list);
+    vector<pair<string, string>> pairs = {
+        {"cat", "dog"}, {"marty", "curls"}, {"code", "data"}, {"work", "play"},
+        {"sleep", "awake"}, {"car", "cheat"}, {"xyz", "aardvark"}, {"cat", "cats"}
+    };
+    
+    for (const auto& [begin, end] : pairs) {
+        vector<string> forward = generate_word_ladder(begin, end, graph, LadderMode::Forward);
+        vector<string> both = generate_word_ladder(begin, end, graph, LadderMode::Bidirectional);
+        EXPECT_EQ(forward.size(), both.size()) << begin << " -> " << end;
+        
+        if (!both.empty()) {
+            EXPECT_EQ(both.front(), begin);
+            EXPECT_EQ(both.back(), end);
+        }
+        for (size_t i = 1; i < both.size(); i++) {
+            EXPECT_TRUE(is_adjacent(both[i-1], both[i]));
+        }
+    }
+}
+
+TEST_F(LadderTest, LoadWordsInternsIntoGraphTest) {
+    WordGraph graph;
+    load_words(graph, "words.txt");
+    
+    ASSERT_EQ(graph.size(), word_list.size());
+    for (const string& word : word_list) {
+        int id = graph.find(word);
+        ASSERT_NE(id, -1) << word;
+        EXPECT_EQ(graph.word(id), word);
+    }
+    EXPECT_EQ(graph.find("notaword"), -1);
+    EXPECT_EQ(generate_word_ladder("code", "data", graph).size(), 6);
+}
+
+TEST(DictionaryTest, GroupsWordsByLengthTest) {
+    Dictionary dict({"dog", "a", "cat", "horse", "cat", "be"});
+    
+    ASSERT_EQ(dict.size(), 5);
+    EXPECT_EQ(dict.max_length(), 5);
+    EXPECT_EQ(dict.word(0), "a");
+    EXPECT_EQ(dict.word(1), "be");
+    EXPECT_EQ(dict.word(2), "cat");
+    EXPECT_EQ(dict.word(3), "dog");
+    EXPECT_EQ(dict.word(4), "horse");
+    
+    EXPECT_EQ(dict.first_of_length(3), 2);
+    EXPECT_EQ(dict.last_of_length(3), 4);
+    EXPECT_EQ(dict.first_of_length(4), dict.last_of_length(4));
+    EXPECT_EQ(string_view(dict.block_of_length(3), 6), "catdog");
+    
+    EXPECT_EQ(dict.find("dog"), 3);
+    EXPECT_EQ(dict.find("do"), -1);
+    EXPECT_EQ(Dictionary().find("dog"), -1);
+}
+
+TEST_F(LadderTest, BatchLaddersKeepInputOrderTest) {
+    WordGraph graph(word_list);
+    stringstream in("cat dog\nmarty curls\ncode data\nwork play\nsleep awake\ncar cheat\nxyz aardvark\n");
+    vector<pair<string, string>> queries = read_word_pairs(in);
+    ASSERT_EQ(queries.size(), 7);
+    
+    vector<vector<string>> ladders = generate_word_ladders(queries, graph, 4);
+    ASSERT_EQ(ladders.size(), queries.size());
+    for (size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(ladders[i], generate_word_ladder(queries[i].first, queries[i].second, graph, LadderMode::Bidirectional));
+    }
+    EXPECT_EQ(ladders[4].size(), 8);
+    EXPECT_TRUE(ladders[6].empty());
+    
+    // Rejected pairs are reported once each, in input order.
+    vector<pair<string, string>> rejected = {{"cat", "qqqq"}, {"dog", "dog"}, {"cat", "dog"}, {"sleep", "zzzz"}};
+    testing::internal::CaptureStderr();
+    generate_word_ladders(rejected, graph, 4);
+    EXPECT_EQ(testing::internal::GetCapturedStderr(),
+        "Error for words 'cat' and 'qqqq': End word not in dictionary\n"
+        "Error for words 'dog' and 'dog': Start and end words are the same\n"
+        "Error for words 'sleep' and 'zzzz': End word not in dictionary\n");
+    
+    stringstream unpaired("cat dog\nsleep\n\n");
+    try {
+        read_word_pairs(unpaired, "pairs.txt");
+        ADD_FAILURE() << "no exception for an unpaired word";
+    } catch (const runtime_error& e) {
+        EXPECT_STREQ(e.what(), "pairs.txt:2: word 'sleep' has no partner");
+    }
+}
+
+static int reference_edit_distance(const string& str1, const string& str2) {
+    vector<int> row(str2.length() + 1);
+    for (size_t j = 0; j <= str2.length(); j++) {
+        row[j] = j;
+    }
+    for (size_t i = 1; i <= str1.length(); i++) {
+        int diagonal = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= str2.length(); j++) {
+            int above = row[j];
+            row[j] = min({row[j] + 1, row[j - 1] + 1, diagonal + (str1[i - 1] != str2[j - 1])});
+            diagonal = above;
+        }
+    }
+    return row.back();
+}
+
+static bool reference_edit_distance_within(const string& str1, const string& str2, int d) {
+    return reference_edit_distance(str1, str2) <= d;
+}
+
+TEST(EditDistanceKernelTest, MatchesReferenceTest) {
+    mt19937 rng(46);
+    for (int trial = 0; trial < 20000; ++trial) {
+        int len = rng() % 70;
+        string a(len, 'a');
+        for (char& c : a) {
+            c = 'a' + rng() % 3;
+        }
+        string b = a;
+        int edits = rng() % 4;
+        for (int e = 0; e < edits; ++e) {
+            int kind = rng() % 3;
+            if (kind == 0 && !b.empty()) {
+                b[rng() % b.size()] = 'a' + rng() % 3;
+            } else if (kind == 1) {
+                b.insert(b.begin() + rng() % (b.size() + 1), 'a' + rng() % 3);
+            } else if (!b.empty()) {
+                b.erase(b.begin() + rng() % b.size());
+            }
+        }
+        for (int d = -1; d <= 3; ++d) {
+            EXPECT_EQ(edit_distance_within(a, b, d), reference_edit_distance_within(a, b, d)) << a << " " << b << " " << d;
+        }
+    }
+}
+
+TEST(EditDistanceKernelTest, BoundedDistanceTest) {
+    EXPECT_EQ(bounded_edit_distance("kitten", "sitting", 10), 3);
+    EXPECT_EQ(bounded_edit_distance("abcd", "bcda", 10), 2);
+    EXPECT_TRUE(edit_distance_within("abcd", "bcda", 2));
+    EXPECT_TRUE(edit_distance_within("cat", "coats", 2));
+    EXPECT_FALSE(edit_distance_within("cat", "coats", 1));
+    EXPECT_EQ(bounded_edit_distance("", "abc", 10), 3);
+    EXPECT_EQ(bounded_edit_distance("same", "same", 0), 0);
+    EXPECT_EQ(bounded_edit_distance("kitten", "sitting", 2), 3);
+    EXPECT_EQ(bounded_edit_distance("a", "abcdefgh", 3), 4);
+    
+    // Patterns spanning several 64-bit blocks.
+    mt19937 rng(64);
+    for (int trial = 0; trial < 300; ++trial) {
+        string a(64 + rng() % 130, 'a');
+        for (char& c : a) {
+            c = 'a' + rng() % 4;
+        }
+        string b = a;
+        int edits = rng() % 12;
+        for (int e = 0; e < edits; ++e) {
+            int at = rng() % (b.size() + 1);
+            if (rng() % 2 == 0) {
+                b.insert(b.begin() + at, 'a' + rng() % 4);
+            } else if (at < static_cast<int>(b.size())) {
+                b[at] = 'a' + rng() % 4;
+            }
+        }
+        int expected = reference_edit_distance(a, b);
+        EXPECT_EQ(bounded_edit_distance(a, b, 1000), expected) << a << " " << b;
+        EXPECT_EQ(bounded_edit_distance(a, b, 5), min(expected, 6)) << a << " " << b;
+    }
+}
+
+TEST_F(LadderTest, BatchEditDistanceMatchesScalarTest) {
+    Dictionary dict(vector<string_view>(word_list.begin(), word_list.end()));
+    
+    for_each_name({"cat", "chat", "sleep", "interstate", "marty"}, [&](const string& word) {
+        for (int group = 1; group <= dict.max_length(); ++group) {
+            int first = dict.first_of_length(group);
+            int count = dict.last_of_length(group) - first;
+            for (int d = 0; d <= 2; ++d) {
+                vector<int> expected;
+                for (int k = 0; k < count; ++k) {
+                    if (edit_distance_within(word, dict.word(first + k), d)) {
+                        expected.push_back(k);
+                    }
+                }
+                vector<int> matches;
+                edit_distance_within_batch(word, dict.block_of_length(group), count, group, d, matches);
+                EXPECT_EQ(matches, expected) << group << " " << d;
+            }
+        }
+    });
+}
+
+TEST_F(LadderTest, GeneratedDictionaryTest) {
+    vector<string> words = generate_dictionary(2000, 11);
+    EXPECT_EQ(words, generate_dictionary(2000, 11));
+    EXPECT_EQ(set<string>(words.begin(), words.end()).size(), words.size());
+    
+    WordGraph graph(set<string>(words.begin(), words.end()));
+    int joined = 0;
+    for (int i = 1; i < 50; ++i) {
+        joined += !generate_word_ladder(words[0], words[i * 37], graph, LadderMode::Bidirectional).empty();
+    }
+    EXPECT_GT(joined, 25);
+}
+
+TEST_F(LadderTest, SearchStatsCountersTest) {
+    WordGraph graph(word_list);
+    for (LadderMode mode : {LadderMode::Forward, LadderMode::Bidirectional}) {
+        SearchStats stats;
+        vector<string> ladder = generate_word_ladder("cat", "dog", graph, mode, stats);
+        EXPECT_EQ(ladder, generate_word_ladder("cat", "dog", graph, mode));
+        EXPECT_GT(stats.nodes_settled, 0);
+        EXPECT_GE(stats.edges_relaxed, stats.distance_updates);
+        EXPECT_EQ(stats.adjacency_checks, 0);
+        
+        SearchStats outside;
+        generate_word_ladder("cqt", "dog", graph, mode, outside);
+        EXPECT_GT(outside.adjacency_checks, 0);
+    }
+    
+    SearchStats batch;
+    vector<pair<string, string>> queries = {{"cat", "dog"}, {"code", "data"}, {"work", "play"}};
+    EXPECT_EQ(generate_word_ladders(queries, graph, batch, 2), generate_word_ladders(queries, graph, 2));
+    EXPECT_GT(batch.nodes_settled, 0);
+}
+
+TEST_F(LadderTest, AllShortestLaddersTest) {
+    WordGraph graph(word_list);
+    LadderWorkspace workspace;
+    for (const auto& [begin, end] : vector<pair<string, string>>{{"cat", "dog"}, {"code", "data"}, {"marty", "curls"}, {"cqt", "dog"}}) {
+        WordLadderDag dag = generate_all_word_ladders(begin, end, graph);
+        vector<string> one = generate_word_ladder(begin, end, graph, LadderMode::Bidirectional);
+        ASSERT_EQ(dag.length(), static_cast<int>(one.size())) << begin << " " << end;
+        
+        // Reference count: shortest-path DP over BFS layers from the end word.
+        vector<int> depth(graph.size(), -1);
+        vector<uint64_t> ways(graph.size(), 0);
+        int end_id = graph.find(end);
+        depth[end_id] = 0;
+        ways[end_id] = 1;
+        vector<int> queue = {end_id};
+        for (size_t head = 0; head < queue.size(); ++head) {
+            int u = queue[head];
+            for (int v : graph.neighbors(u)) {
+                if (depth[v] == -1) {
+                    depth[v] = depth[u] + 1;
+                    queue.push_back(v);
+                }
+                if (depth[v] == depth[u] + 1) {
+                    ways[v] += ways[u];
+                }
+            }
+        }
+        uint64_t expected = 0;
+        int begin_id = graph.find(begin);
+        if (begin_id != -1) {
+            expected = ways[begin_id];
+        } else {
+            int best = INF;
+            for (int v : graph.neighbors_of(begin)) {
+                if (depth[v] != -1 && depth[v] < best) {
+                    best = depth[v];
+                    expected = 0;
+                }
+                expected += depth[v] == best ? ways[v] : 0;
+            }
+        }
+        EXPECT_EQ(dag.count(), expected) << begin << " " << end;
+        
+        set<vector<string>> seen;
+        for (const vector<string>& ladder : dag) {
+            ASSERT_EQ(ladder.size(), one.size());
+            EXPECT_EQ(ladder.front(), begin);
+            EXPECT_EQ(ladder.back(), end);
+            for (size_t i = 0; i + 1 < ladder.size(); ++i) {
+                EXPECT_TRUE(is_adjacent(ladder[i], ladder[i + 1])) << ladder[i] << " " << ladder[i + 1];
+            }
+            EXPECT_TRUE(seen.insert(ladder).second);
+        }
+        EXPECT_EQ(seen.size(), expected);
+        EXPECT_TRUE(seen.count(one));
+        
+        // A workspace reused across queries builds the same DAG.
+        WordLadderDag reused = generate_all_word_ladders(begin, end, graph, workspace);
+        set<vector<string>> reused_ladders;
+        for (const vector<string>& ladder : reused) {
+            reused_ladders.insert(ladder);
+        }
+        EXPECT_EQ(reused_ladders, seen) << begin << " " << end;
+    }
+    
+    EXPECT_TRUE(generate_all_word_ladders("cat", "cat", graph).empty());
+    EXPECT_EQ(generate_all_word_ladders("cat", "zzzzq", graph).count(), 0u);
+    EXPECT_FALSE(generate_all_word_ladders("cat", "zzzzq", graph).begin() != WordLadderDag().end());
+}
+
+TEST_F(LadderTest, WordGraphSnapshotTest) {
+    WordGraph graph(word_list);
+    string filename = testing::TempDir() + "words.snapshot";
+    save_word_graph(graph, filename);
+    EXPECT_TRUE(is_word_graph_snapshot(filename));
+    EXPECT_FALSE(is_word_graph_snapshot("words.txt"));
+    
+    WordGraph loaded;
+    read_word_graph(loaded, filename);
+    EXPECT_EQ(loaded.dict.arena, graph.dict.arena);
+    EXPECT_EQ(loaded.dict.offsets, graph.dict.offsets);
+    EXPECT_EQ(loaded.dict.length_begin, graph.dict.length_begin);
+    EXPECT_EQ(loaded.dict.table, graph.dict.table);
+    EXPECT_EQ(loaded.offsets, graph.offsets);
+    EXPECT_EQ(loaded.adjacent, graph.adjacent);
+    EXPECT_EQ(loaded.find("marty"), graph.find("marty"));
+    EXPECT_EQ(generate_word_ladder("marty", "curls", loaded, LadderMode::Bidirectional).size(), 6u);
+    
+    // Corrupt copies: truncated, and a neighbor ID pointing past the end.
+    ifstream in(filename, ios::binary);
+    string bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    in.close();
+    auto rewrite = [&](const string& content) {
+        ofstream out(filename, ios::binary | ios::trunc);
+        out << content;
+    };
+    rewrite(bytes.substr(0, bytes.size() - 1));
+    EXPECT_THROW(read_word_graph(loaded, filename), runtime_error);
+    
+    string corrupt = bytes;
+    size_t adjacent = sizeof(WordGraphHeader) + (2 * (graph.size() + 1) + graph.dict.length_begin.size() + graph.dict.table.size()) * 4;
+    int bad = graph.size();
+    memcpy(&corrupt[adjacent], &bad, sizeof(bad));
+    rewrite(corrupt);
+    EXPECT_THROW(read_word_graph(loaded, filename), runtime_error);
+    remove(filename.c_str());
+    
+    try {
+        read_word_graph(loaded, filename);
+        ADD_FAILURE() << "no exception for a missing snapshot";
+    } catch (const runtime_error& e) {
+        EXPECT_EQ(string(e.what()), "Cannot open word graph snapshot: " + filename);
+    }
+}
+
+TEST_F(LadderTest, BkTreeWithinMatchesScanTest) {
+    Dictionary dict(vector<string_view>(word_list.begin(), word_list.end()));
+    BkTree tree(dict);
+    EXPECT_EQ(tree.size(), dict.size());
+    
+    for_each_name({"cat", "chat", "sleep", "interstate", "marty", "qzx"}, [&](const string& word) {
+        for (int d = 0; d <= 2; ++d) {
+            vector<int> expected;
+            for (int id = 0; id < dict.size(); ++id) {
+                if (edit_distance_within(word, dict.word(id), d)) {
+                    expected.push_back(id);
+                }
+            }
+            long long comparisons = 0;
+            EXPECT_EQ(tree.within(word, d, &comparisons), expected) << d;
+            EXPECT_LT(comparisons, dict.size()) << d;
+        }
+    });
+    EXPECT_TRUE(tree.within("cat", -1).empty());
+    EXPECT_TRUE(BkTree().within("cat", 2).empty());
+    
+    // Any d at least as long as every word matches the whole dictionary.
+    vector<int> everything(dict.size());
+    iota(everything.begin(), everything.end(), 0);
+    EXPECT_EQ(tree.within("cat", INF), everything);
+}
+
+TEST_F(LadderTest, LadderWorkspaceReuseTest) {
+    WordGraph graph(word_list);
+    LadderWorkspace workspace;
+    vector<pair<string, string>> queries = {
+        {"cat", "dog"}, {"sleep", "awake"}, {"Marty", "curls"}, {"cat", "cat"},
+        {"qzxv", "cat"}, {"cat", "notaword"}, {"aarhus", "cat"}, {"code", "data"}
+    };
+    for (LadderMode mode : {LadderMode::Forward, LadderMode::Bidirectional}) {
+        for (const auto& [begin, end] : queries) {
+            vector<string> expected = generate_word_ladder(begin, end, graph, mode);
+            span<const int> ids = generate_word_ladder(begin, end, graph, workspace, mode);
+            EXPECT_EQ(ids.size(), expected.size()) << begin << " " << end;
+            EXPECT_EQ(workspace.words(graph), expected) << begin << " " << end;
+        }
+    }
+    
+    // Stamps are wiped when the generation wraps.
+    StampedMarks marks;
+    marks.reset(4);
+    marks.set(2, -1);
+    marks.generation = numeric_limits<uint32_t>::max();
+    marks.reset(4);
+    EXPECT_EQ(marks.generation, 1u);
+    for (int id = 0; id < 4; ++id) {
+        EXPECT_FALSE(marks.test(id));
+    }
+}
@@ -0,0 +1,254 @@
+#include "dijkstras.h"
+#include "ladder.h"
+#include "generators.h"
+#include "bk_tree.h"
+#include "dijkstra_engine.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <sys/resource.h>
+
+using namespace std;
+
+// Seeded benchmark suite: generates random, grid and power-law graphs and
+// synthetic dictionaries, then times loading and querying them. Every row
+// reports the load time, per-query latency percentiles, throughput, heap
+// allocations per query and the process's peak RSS so far (ru_maxrss only
+// grows, so rows are cumulative).
+
+// Counts every allocation made through operator new, which is where all of
+// the engines' containers get their memory.
+static atomic<long long> allocations(0);
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    if (void* block = malloc(size == 0 ? 1 : size)) {
+        return block;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void* block) noexcept {
+    free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    free(block);
+}
+
+using Clock = chrono::steady_clock;
+
+static double elapsed_ms(Clock::time_point start) {
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+static double peak_rss_mb() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;
+}
+
+struct BenchOptions {
+    long long max_edges = 1000000;
+    int max_words = 100000;
+    int queries = 32;
+    uint64_t seed = 1;
+    filesystem::path dir = filesystem::temp_directory_path();
+};
+
+static void print_header() {
+    cout << left << setw(12) << "workload" << right << setw(10) << "size"
+         << "  " << left << setw(28) << "operation" << right
+         << setw(10) << "load_ms" << setw(10) << "p50_us" << setw(10) << "p90_us"
+         << setw(10) << "p99_us" << setw(10) << "max_us" << setw(10) << "qps"
+         << setw(10) << "allocs" << setw(10) << "rss_mb" << '\n';
+}
+
+static double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+// Runs query(i) for every i < count and prints one row. load_ms < 0 means
+// the row has no load phase.
+static void report(const string& workload, long long size, const string& operation, double load_ms, int count, const function<void(int)>& query) {
+    vector<double> latencies;
+    latencies.reserve(count);
+    long long allocated = allocations.load();
+    auto total_start = Clock::now();
+    for (int i = 0; i < count; ++i) {
+        auto start = Clock::now();
+        query(i);
+        latencies.push_back(chrono::duration<double, micro>(Clock::now() - start).count());
+    }
+    double total_ms = elapsed_ms(total_start);
+    allocated = allocations.load() - allocated;
+    sort(latencies.begin(), latencies.end());
+
+    cout << left << setw(12) << workload << right << setw(10) << size
+         << "  " << left << setw(28) << operation << right << fixed << setprecision(1);
+    if (load_ms < 0) {
+        cout << setw(10) << "-";
+    } else {
+        cout << setw(10) << load_ms;
+    }
+    cout << setw(10) << percentile(latencies, 0.50) << setw(10) << percentile(latencies, 0.90)
+         << setw(10) << percentile(latencies, 0.99) << setw(10) << (latencies.empty() ? 0 : latencies.back())
+         << setw(10) << (total_ms > 0 ? count * 1000.0 / total_ms : 0)
+         << setw(10) << double(allocated) / count << setw(10) << peak_rss_mb() << '\n' << flush;
+}
+
+static void bench_graph(const string& workload, const CsrGraph& generated, const BenchOptions& options) {
+    string filename = (options.dir / ("hw9_bench_" + workload + ".txt")).string();
+    write_graph_text(generated, filename);
+    long long edges = generated.numEdges();
+
+    auto start = Clock::now();
+    Graph G;
+    file_to_graph(filename, G);
+    double graph_load = elapsed_ms(start);
+
+    start = Clock::now();
+    CsrGraph csr;
+    file_to_graph(filename, csr);
+    double csr_load = elapsed_ms(start);
+    filesystem::remove(filename);
+
+    mt19937_64 rng(options.seed);
+    vector<int> sources(options.queries);
+    for (int& source : sources) {
+        source = uniform_int_distribution<int>(0, G.numVertices - 1)(rng);
+    }
+
+    vector<int> previous;
+    report(workload, edges, "dijkstra Graph heap", graph_load, options.queries, [&](int i) {
+        dijkstra_shortest_path(G, sources[i], previous);
+    });
+    report(workload, edges, "dijkstra CsrGraph heap", csr_load, options.queries, [&](int i) {
+        dijkstra_shortest_path(csr, sources[i], previous);
+    });
+    report(workload, edges, "dijkstra CsrGraph buckets", -1, options.queries, [&](int i) {
+        dijkstra_shortest_path(csr, sources[i], previous, DijkstraQueue::Buckets);
+    });
+    report(workload, edges, "dijkstra CsrGraph indexed", -1, options.queries, [&](int i) {
+        dijkstra_shortest_path(csr, sources[i], previous, DijkstraQueue::IndexedHeap);
+    });
+
+    // Warmed up on the first source, so the row shows the steady state.
+    DijkstraWorkspace workspace;
+    dijkstra_shortest_path(csr, sources[0], workspace);
+    report(workload, edges, "dijkstra CsrGraph workspace", -1, options.queries, [&](int i) {
+        dijkstra_shortest_path(csr, sources[i], workspace);
+    });
+}
+
+static void bench_dictionary(int count, const BenchOptions& options) {
+    vector<string> words = generate_dictionary(count, options.seed);
+    string filename = (options.dir / "hw9_bench_words.txt").string();
+    write_words(words, filename);
+
+    auto start = Clock::now();
+    set<string> word_list;
+    load_words(word_list, filename);
+    double set_load = elapsed_ms(start);
+
+    start = Clock::now();
+    WordGraph graph;
+    load_words(graph, filename);
+    double graph_load = elapsed_ms(start);
+    filesystem::remove(filename);
+
+    mt19937_64 rng(options.seed);
+    vector<pair<string, string>> pairs(options.queries);
+    for (auto& [begin, end] : pairs) {
+        begin = words[uniform_int_distribution<size_t>(0, words.size() - 1)(rng)];
+        end = words[uniform_int_distribution<size_t>(0, words.size() - 1)(rng)];
+    }
+
+    // The set<string> overload builds its word graph on the first call and
+    // afterwards only checks that the set still matches it.
+    report("dictionary", count, "ladder set<string>", set_load, options.queries, [&](int i) {
+        generate_word_ladder(pairs[i].first, pairs[i].second, word_list);
+    });
+    report("dictionary", count, "ladder WordGraph forward", graph_load, options.queries, [&](int i) {
+        generate_word_ladder(pairs[i].first, pairs[i].second, graph, LadderMode::Forward);
+    });
+    report("dictionary", count, "ladder WordGraph bidir", -1, options.queries, [&](int i) {
+        generate_word_ladder(pairs[i].first, pairs[i].second, graph, LadderMode::Bidirectional);
+    });
+    LadderWorkspace workspace;
+    generate_word_ladder(pairs[0].first, pairs[0].second, graph, workspace, LadderMode::Bidirectional);
+    report("dictionary", count, "ladder workspace bidir", -1, options.queries, [&](int i) {
+        generate_word_ladder(pairs[i].first, pairs[i].second, graph, workspace, LadderMode::Bidirectional);
+    });
+
+    // Typo-tolerant lookup: every word within distance 2, by scanning the
+    // lengths that can match and through the BK-tree.
+    report("dictionary", count, "within-2 length scan", -1, options.queries, [&](int i) {
+        const string& word = pairs[i].first;
+        vector<int> matches;
+        for (int group = max<int>(1, word.length() - 2); group <= static_cast<int>(word.length()) + 2; ++group) {
+            int first = graph.dict.first_of_length(group);
+            edit_distance_within_batch(word, graph.dict.block_of_length(group), graph.dict.last_of_length(group) - first, group, 2, matches);
+        }
+    });
+    start = Clock::now();
+    BkTree tree(graph.dict);
+    double tree_build = elapsed_ms(start);
+    report("dictionary", count, "within-2 BkTree", tree_build, options.queries, [&](int i) {
+        tree.within(pairs[i].first, 2);
+    });
+}
+
+static void usage() {
+    cerr << "usage: bench_main [--max-edges N] [--max-words N] [--queries N] [--seed N] [--dir DIR]" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            usage();
+            return 1;
+        }
+        string value = argv[++i];
+        if (arg == "--max-edges") {
+            options.max_edges = min(stoll(value), 10000000LL);
+        } else if (arg == "--max-words") {
+            options.max_words = stoi(value);
+        } else if (arg == "--queries") {
+            options.queries = max(1, stoi(value));
+        } else if (arg == "--seed") {
+            options.seed = stoull(value);
+        } else if (arg == "--dir") {
+            options.dir = value;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    print_header();
+    for (long long edges = 1000; edges <= options.max_edges; edges *= 10) {
+        int n = max(2LL, edges / 8);
+        bench_graph("random", generate_random_graph(n, edges, 100, options.seed), options);
+
+        int side = max(2, static_cast<int>(sqrt(edges / 4.0)));
+        bench_graph("grid", generate_grid_graph(side, 100, options.seed), options);
+
+        bench_graph("power-law", generate_power_law_graph(max(2LL, edges / 8), 4, 100, options.seed), options);
+    }
+    for (int words = 1000; words <= options.max_words; words *= 10) {
+        bench_dictionary(words, options);
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include "bk_tree.h"
+#include "ladder.h"
+
+#include <limits>
+#include <random>
+
+// Exact distances are needed to pick children, so they are never capped.
+static const int UNBOUNDED = numeric_limits<int>::max() - 1;
+
+BkTree::BkTree(const Dictionary& dict) : BkTree() {
+    const int n = dict.size();
+    if (n == 0) {
+        return;
+    }
+
+    // Dictionary IDs run in length-then-alphabetical order, which would
+    // grow long chains of near-identical words; a fixed shuffle keeps the
+    // tree shallow and the layout reproducible.
+    vector<int> order(n);
+    for (int id = 0; id < n; ++id) {
+        order[id] = id;
+    }
+    shuffle(order.begin(), order.end(), mt19937(46));
+
+    // Grow the tree with sibling lists, indexed by insertion position.
+    vector<int> first_child(n, -1);
+    vector<int> next_sibling(n, -1);
+    vector<int> parent_edge(n, 0);
+    for (int k = 1; k < n; ++k) {
+        string_view inserted = dict.word(order[k]);
+        int node = 0;
+        while (true) {
+            int dist = bounded_edit_distance(inserted, dict.word(order[node]), UNBOUNDED);
+            int child = first_child[node];
+            while (child != -1 && parent_edge[child] != dist) {
+                child = next_sibling[child];
+            }
+            if (child == -1) {
+                parent_edge[k] = dist;
+                next_sibling[k] = first_child[node];
+                first_child[node] = k;
+                break;
+            }
+            node = child;
+        }
+    }
+
+    // Freeze breadth first, each node's children sorted by edge. Children
+    // are appended in parent order, so each run starts where the previous
+    // node's ended, the root's right after the root.
+    vector<int> frozen = {0};
+    child_begin = {1};
+    frozen.reserve(n);
+    ids.reserve(n);
+    edge.reserve(n);
+    offsets.reserve(n + 1);
+    child_begin.reserve(n + 1);
+    for (size_t at = 0; at < frozen.size(); ++at) {
+        int node = frozen[at];
+        ids.push_back(order[node]);
+        edge.push_back(parent_edge[node]);
+        string_view text = dict.word(order[node]);
+        arena.insert(arena.end(), text.begin(), text.end());
+        offsets.push_back(arena.size());
+
+        size_t first = frozen.size();
+        for (int child = first_child[node]; child != -1; child = next_sibling[child]) {
+            frozen.push_back(child);
+        }
+        sort(frozen.begin() + first, frozen.end(), [&](int a, int b) {
+            return parent_edge[a] < parent_edge[b];
+        });
+        child_begin.push_back(frozen.size());
+    }
+}
+
+vector<int> BkTree::within(string_view word, int d, long long* comparisons) const {
+    vector<int> found;
+    if (ids.empty() || d < 0) {
+        return found;
+    }
+
+    EditDistancePattern query(word);
+    vector<int> pending = {0};
+    long long computed = 0;
+    while (!pending.empty()) {
+        int node = pending.back();
+        pending.pop_back();
+        int dist = query.distance(this->word(node), UNBOUNDED);
+        ++computed;
+        if (dist <= d) {
+            found.push_back(ids[node]);
+        }
+        // In long long, so a d near INT_MAX cannot overflow the bound.
+        for (int child = child_begin[node]; child < child_begin[node + 1] && edge[child] <= static_cast<long long>(dist) + d; ++child) {
+            if (edge[child] >= dist - d) {
+                pending.push_back(child);
+            }
+        }
+    }
+
+    if (comparisons) {
+        *comparisons += computed;
+    }
+    sort(found.begin(), found.end());
+    return found;
+}
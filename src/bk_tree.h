@@ -0,0 +1,48 @@
+#ifndef BK_TREE_H
+#define BK_TREE_H
+
+#include <string_view>
+#include <vector>
+
+#include "dictionary.h"
+
+using namespace std;
+
+// Burkhard-Keller tree over a dictionary under edit distance. Each node is a
+// word, and a child hangs off its parent under their exact distance. By the
+// triangle inequality, words within d of a query can only sit below children
+// whose edge lies in [dist - d, dist + d], where dist is the query's distance
+// to the parent. For small d that prunes most of the tree, so a query
+// computes distances to a fraction of the dictionary instead of all of it.
+//
+// The finished tree is frozen in breadth-first order: each node's children
+// are one contiguous run sorted by edge, and the node words are copied into
+// an arena in the same order, so a query walks memory roughly front to back.
+class BkTree {
+public:
+    BkTree() : offsets(1, 0), child_begin(1, 0) {}
+    explicit BkTree(const Dictionary& dict);
+
+    int size() const {
+        return ids.size();
+    }
+
+    // Dictionary IDs of every word within edit distance d of word, in
+    // ascending order. The word itself is included when it is in the
+    // dictionary. When comparisons is given, the number of distances
+    // computed is added to it.
+    vector<int> within(string_view word, int d, long long* comparisons = nullptr) const;
+
+private:
+    vector<int> ids;            // node -> dictionary ID; node 0 is the root
+    vector<char> arena;
+    vector<uint32_t> offsets;   // node word is arena[offsets[node], offsets[node + 1])
+    vector<int> child_begin;    // children of node are [child_begin[node], child_begin[node + 1])
+    vector<int> edge;           // distance from a node to its parent
+
+    string_view word(int node) const {
+        return string_view(arena.data() + offsets[node], offsets[node + 1] - offsets[node]);
+    }
+};
+
+#endif // BK_TREE_H
@@ -0,0 +1,205 @@
+#include "dijkstras.h"
+#include "dijkstra_engine.h"
+
+#include <atomic>
+#include <barrier>
+#include <exception>
+#include <thread>
+
+// Distance and parent packed into one word so a single compare-and-swap
+// updates both: the high half is the distance, the low half parent + 1.
+static uint64_t pack(int distance, int parent) {
+    return (static_cast<uint64_t>(distance) << 32) | static_cast<uint32_t>(parent + 1);
+}
+
+static int unpack_distance(uint64_t label) {
+    return static_cast<int>(label >> 32);
+}
+
+static int unpack_parent(uint64_t label) {
+    return static_cast<int>(static_cast<uint32_t>(label)) - 1;
+}
+
+// Upper bound on the circular bucket array each worker keeps.
+const int MAX_DELTA_BUCKETS = 1 << 12;
+
+template <typename GraphT>
+vector<int> delta_stepping_shortest_path(const GraphT& G, int source, vector<int>& previous, int delta, int num_threads) {
+    int n = G.numVertices;
+    long long total_edges = 0;
+    int max_weight = 0;
+    for (int u = 0; u < n; ++u) {
+        for (const Edge& edge : G[u]) {
+            if (edge.weight < 0) {
+                throw invalid_argument("Delta-stepping requires non-negative edge weights");
+            }
+            max_weight = max(max_weight, edge.weight);
+            ++total_edges;
+        }
+    }
+    if (delta <= 0) {
+        long long average_degree = max(1LL, total_edges / max(1, n));
+        delta = max(1LL, max_weight / average_degree);
+    }
+    if (num_threads <= 0) {
+        num_threads = max(1u, thread::hardware_concurrency());
+    }
+
+    // The circular bucket array below holds max_weight / delta + 2 buckets
+    // per worker, so a tiny delta against heavy weights is raised until that
+    // fits. Any delta gives the same distances; only the number of phases
+    // changes.
+    delta = max<long long>(delta, max_weight / (MAX_DELTA_BUCKETS - 2) + 1);
+
+    vector<atomic<uint64_t>> labels(n);
+    for (int v = 0; v < n; ++v) {
+        labels[v].store(pack(INF, -1), memory_order_relaxed);
+    }
+    labels[source].store(pack(0, -1), memory_order_relaxed);
+
+    auto distance_of = [&](int v) {
+        return unpack_distance(labels[v].load(memory_order_relaxed));
+    };
+
+    // Every queued vertex lies within max_weight of the bucket being
+    // processed, so its bucket index is at most max_weight / delta + 1 ahead
+    // (one more than that bound when delta does not divide the remainder)
+    // and a circular array of that many buckets never collides. Each worker
+    // files into its own array, so relaxations need no lock; the arrays are
+    // sized here because the barrier completion below must not grow them.
+    size_t bucket_count = max_weight / delta + 2;
+    vector<vector<vector<int>>> buckets(num_threads, vector<vector<int>>(bucket_count));
+    buckets[0][0].push_back(source);
+
+    // Atomic min on the distance half; the parent only changes together with
+    // a strict improvement, so it always points at a vertex that was at
+    // least as close, and the parent graph stays acyclic. The winner files
+    // the vertex under its new distance; a later improvement files it again
+    // and take_bucket drops the stale entry.
+    auto relax = [&](int u, int du, const Edge& edge, vector<vector<int>>& filed) {
+        int candidate = saturating_add(du, edge.weight);
+        uint64_t current = labels[edge.dst].load(memory_order_relaxed);
+        while (candidate < unpack_distance(current)) {
+            if (labels[edge.dst].compare_exchange_weak(current, pack(candidate, u), memory_order_relaxed)) {
+                filed[static_cast<size_t>(candidate / delta) % bucket_count].push_back(edge.dst);
+                break;
+            }
+        }
+    };
+
+    vector<int> frontier;
+    vector<int> settled;
+    vector<int> frontier_stamp(n, -1);
+    vector<int> settled_stamp(n, -1);
+    size_t current = 0;
+    bool heavy_phase = false;
+    bool done = false;
+    int step = 0;
+
+    auto bucket_of = [&](int v) {
+        return static_cast<size_t>(distance_of(v) / delta);
+    };
+
+    // Pulls the live, distinct entries of the current bucket from every
+    // worker into the frontier; stale entries whose vertex has since moved
+    // are dropped.
+    auto take_bucket = [&]() {
+        frontier.clear();
+        ++step;
+        for (vector<vector<int>>& filed : buckets) {
+            vector<int>& bucket = filed[current % bucket_count];
+            for (int v : bucket) {
+                if (frontier_stamp[v] != step && bucket_of(v) == current) {
+                    frontier_stamp[v] = step;
+                    frontier.push_back(v);
+                    if (settled_stamp[v] != static_cast<int>(current)) {
+                        settled_stamp[v] = current;
+                        settled.push_back(v);
+                    }
+                }
+            }
+            bucket.clear();
+        }
+    };
+
+    // Serial step between parallel phases: choose what the workers relax
+    // next. std::barrier needs the completion to be noexcept, so a failed
+    // allocation is kept and rethrown once the workers have stopped.
+    exception_ptr failure;
+    auto step_phase = [&]() {
+        if (!heavy_phase) {
+            take_bucket();
+            if (!frontier.empty()) {
+                return;
+            }
+            heavy_phase = true;
+            frontier.swap(settled);
+            return;
+        }
+
+        heavy_phase = false;
+        settled.clear();
+        for (size_t scanned = 0; scanned < bucket_count; ++scanned) {
+            ++current;
+            take_bucket();
+            if (!frontier.empty()) {
+                return;
+            }
+        }
+        done = true;
+    };
+
+    auto advance = [&]() noexcept {
+        try {
+            step_phase();
+        } catch (...) {
+            failure = current_exception();
+            done = true;
+        }
+    };
+
+    take_bucket();
+    barrier sync(num_threads, advance);
+
+    auto worker = [&](int t) {
+        while (!done) {
+            size_t first = frontier.size() * t / num_threads;
+            size_t last = frontier.size() * (t + 1) / num_threads;
+            for (size_t i = first; i < last; ++i) {
+                int u = frontier[i];
+                int du = distance_of(u);
+                for (const Edge& edge : G[u]) {
+                    if ((edge.weight <= delta) != heavy_phase) {
+                        relax(u, du, edge, buckets[t]);
+                    }
+                }
+            }
+            sync.arrive_and_wait();
+        }
+    };
+
+    vector<thread> pool;
+    for (int t = 1; t < num_threads; ++t) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for (thread& t : pool) {
+        t.join();
+    }
+    if (failure) {
+        rethrow_exception(failure);
+    }
+
+    vector<int> distance(n);
+    previous.assign(n, -1);
+    for (int v = 0; v < n; ++v) {
+        uint64_t label = labels[v].load(memory_order_relaxed);
+        distance[v] = unpack_distance(label);
+        previous[v] = unpack_parent(label);
+    }
+    return distance;
+}
+
+template vector<int> delta_stepping_shortest_path(const Graph& G, int source, vector<int>& previous, int delta, int num_threads);
+template vector<int> delta_stepping_shortest_path(const CsrGraph& G, int source, vector<int>& previous, int delta, int num_threads);
+template vector<int> delta_stepping_shortest_path(const MappedGraph& G, int source, vector<int>& previous, int delta, int num_threads);
@@ -0,0 +1,65 @@
+#include "dictionary.h"
+
+#include <algorithm>
+
+static uint64_t hash_word(string_view word) {
+    uint64_t h = 14695981039346656037ull;
+    for (char c : word) {
+        h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    return h;
+}
+
+Dictionary::Dictionary(vector<string_view> words) {
+    sort(words.begin(), words.end(), [](string_view a, string_view b) {
+        return a.length() != b.length() ? a.length() < b.length() : a < b;
+    });
+    words.erase(unique(words.begin(), words.end()), words.end());
+
+    size_t total = 0;
+    for (string_view w : words) {
+        total += w.length();
+    }
+    arena.reserve(total);
+    offsets.reserve(words.size() + 1);
+    offsets.assign(1, 0);
+
+    size_t max_len = words.empty() ? 0 : words.back().length();
+    length_begin.assign(max_len + 2, 0);
+
+    for (size_t id = 0; id < words.size(); ++id) {
+        arena.insert(arena.end(), words[id].begin(), words[id].end());
+        offsets.push_back(arena.size());
+        length_begin[words[id].length() + 1] = id + 1;
+    }
+    for (size_t len = 1; len < length_begin.size(); ++len) {
+        length_begin[len] = max(length_begin[len], length_begin[len - 1]);
+    }
+
+    size_t capacity = 16;
+    while (capacity < 2 * words.size()) {
+        capacity *= 2;
+    }
+    table.assign(capacity, 0);
+    for (int id = 0; id < size(); ++id) {
+        size_t slot = hash_word(word(id)) & (capacity - 1);
+        while (table[slot] != 0) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        table[slot] = id + 1;
+    }
+}
+
+int Dictionary::find(string_view word) const {
+    if (table.empty()) {
+        return -1;
+    }
+    size_t mask = table.size() - 1;
+    for (size_t slot = hash_word(word) & mask; table[slot] != 0; slot = (slot + 1) & mask) {
+        int id = table[slot] - 1;
+        if (this->word(id) == word) {
+            return id;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,84 @@
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <algorithm>
+
+using namespace std;
+
+// Immutable word store. Every word lives in one contiguous char arena; IDs
+// are ordered by length and then alphabetically, so all words of length L
+// form the ID range [length_begin[L], length_begin[L + 1]) and occupy one
+// packed block of the arena. Lookup is an open-addressing hash of IDs.
+struct Dictionary {
+    vector<char> arena;
+    vector<uint32_t> offsets;
+    vector<uint32_t> length_begin;
+    vector<uint32_t> table;
+
+    Dictionary() : offsets(1, 0), length_begin(1, 0) {}
+
+    // Interns the given words; duplicates are dropped.
+    explicit Dictionary(vector<string_view> words);
+
+    int size() const {
+        return offsets.size() - 1;
+    }
+
+    int max_length() const {
+        return length_begin.size() - 2;
+    }
+
+    string_view word(int id) const {
+        return string_view(arena.data() + offsets[id], offsets[id + 1] - offsets[id]);
+    }
+
+    int first_of_length(int length) const {
+        return length > max_length() ? size() : length_begin[length];
+    }
+
+    int last_of_length(int length) const {
+        return length > max_length() ? size() : length_begin[length + 1];
+    }
+
+    // Start of the packed block holding every word of the given length.
+    const char* block_of_length(int length) const {
+        return arena.data() + offsets[first_of_length(length)];
+    }
+
+    int find(string_view word) const;
+};
+
+// Visited set with parent links over word IDs that resets in O(1): an ID
+// is marked when its stamp equals the current generation, so clearing is
+// one increment. The stamps are only wiped when the 32-bit counter wraps.
+struct StampedMarks {
+    vector<uint32_t> stamp;
+    vector<int> parent;
+    uint32_t generation = 0;
+
+    void reset(int n) {
+        if (stamp.size() < static_cast<size_t>(n)) {
+            stamp.resize(n, 0);
+            parent.resize(n);
+        }
+        if (++generation == 0) {
+            fill(stamp.begin(), stamp.end(), 0);
+            generation = 1;
+        }
+    }
+
+    bool test(int id) const {
+        return stamp[id] == generation;
+    }
+
+    void set(int id, int from) {
+        stamp[id] = generation;
+        parent[id] = from;
+    }
+};
+
+#endif // DICTIONARY_H
@@ -0,0 +1,474 @@
+#ifndef DIJKSTRA_ENGINE_H
+#define DIJKSTRA_ENGINE_H
+
+#include <type_traits>
+#include <utility>
+
+#include "dijkstras.h"
+
+// Dijkstra compiled per weight type, graph layout and queue policy. The int
+// dijkstra_shortest_path overloads are thin wrappers over this engine; other
+// instantiations (64-bit costs, 16-bit weights, floating point) go through
+// basic_dijkstra_shortest_path.
+
+// Distances for weights narrower than int are accumulated in int, so a
+// uint16_t graph still reports path costs beyond 65535.
+template <typename W>
+using DistanceOf = conditional_t<is_integral_v<W> && (sizeof(W) < sizeof(int)), int, W>;
+
+// Distance of an unreachable vertex: the largest value (infinity for
+// floating point), which equals INF for int.
+template <typename D>
+constexpr D unreachable_distance() {
+    if constexpr (numeric_limits<D>::has_infinity) {
+        return numeric_limits<D>::infinity();
+    } else {
+        return numeric_limits<D>::max();
+    }
+}
+
+// distance + weight clamped to the unreachable sentinel. An unreachable
+// distance stays unreachable and an overflowing sum becomes unreachable, so
+// the relaxation needs no separate "distance[u] != INF" test.
+template <typename D, typename W>
+constexpr D saturating_add(D distance, W weight) {
+    D step = static_cast<D>(weight);
+    if constexpr (!numeric_limits<D>::has_infinity) {
+        if (step > 0 && distance > unreachable_distance<D>() - step) {
+            return unreachable_distance<D>();
+        }
+    }
+    return distance + step;
+}
+
+template <typename W>
+struct BasicEdge {
+    int dst;
+    W weight;
+    BasicEdge(int d, W w) : dst(d), weight(w) {}
+};
+
+// Converts an int weight, rejecting values the narrower type cannot hold.
+template <typename W>
+W narrow_weight(int weight) {
+    if constexpr (is_integral_v<W>) {
+        if (!in_range<W>(weight)) {
+            throw out_of_range("Edge weight " + to_string(weight) + " does not fit the graph's weight type");
+        }
+    }
+    return static_cast<W>(weight);
+}
+
+// Adjacency-list layout with weight type W.
+template <typename W>
+struct BasicGraph {
+    int numVertices = 0;
+    vector<vector<BasicEdge<W>>> adjacencyList;
+
+    BasicGraph() = default;
+
+    explicit BasicGraph(const Graph& G) : numVertices(G.numVertices), adjacencyList(G.numVertices) {
+        for (int u = 0; u < numVertices; ++u) {
+            adjacencyList[u].reserve(G[u].size());
+            for (const Edge& edge : G[u]) {
+                adjacencyList[u].emplace_back(edge.dst, narrow_weight<W>(edge.weight));
+            }
+        }
+    }
+
+    void resize(int n) {
+        numVertices = n;
+        adjacencyList.resize(n);
+    }
+
+    const vector<BasicEdge<W>>& operator[](int index) const {
+        return adjacencyList[index];
+    }
+
+    vector<BasicEdge<W>>& operator[](int index) {
+        return adjacencyList[index];
+    }
+};
+
+// CSR layout with weight type W. Destinations and weights are separate
+// arrays, so a uint16_t graph streams 6 bytes per edge instead of 8.
+template <typename W>
+struct BasicCsrGraph {
+    int numVertices = 0;
+    vector<int> offsets = vector<int>(1, 0);
+    vector<int> dsts;
+    vector<W> weights;
+
+    struct EdgeRange {
+        const int* dst;
+        const W* weight;
+        int count;
+
+        struct iterator {
+            const int* dst;
+            const W* weight;
+            BasicEdge<W> operator*() const {
+                return BasicEdge<W>(*dst, *weight);
+            }
+            iterator& operator++() {
+                ++dst;
+                ++weight;
+                return *this;
+            }
+            bool operator!=(const iterator& other) const {
+                return dst != other.dst;
+            }
+        };
+
+        iterator begin() const {
+            return {dst, weight};
+        }
+
+        iterator end() const {
+            return {dst + count, weight + count};
+        }
+
+        int size() const {
+            return count;
+        }
+    };
+
+    BasicCsrGraph() = default;
+
+    template <typename GraphT>
+    explicit BasicCsrGraph(const GraphT& G) : numVertices(G.numVertices), offsets(G.numVertices + 1, 0) {
+        for (int u = 0; u < numVertices; ++u) {
+            offsets[u + 1] = offsets[u] + G[u].size();
+        }
+        dsts.reserve(offsets.back());
+        weights.reserve(offsets.back());
+        for (int u = 0; u < numVertices; ++u) {
+            for (const auto& edge : G[u]) {
+                dsts.push_back(edge.dst);
+                weights.push_back(narrow_weight<W>(edge.weight));
+            }
+        }
+    }
+
+    int numEdges() const {
+        return dsts.size();
+    }
+
+    EdgeRange operator[](int index) const {
+        return {dsts.data() + offsets[index], weights.data() + offsets[index], offsets[index + 1] - offsets[index]};
+    }
+};
+
+// Weight type of any layout whose G[u] yields edges with dst and weight.
+template <typename GraphT>
+using WeightOf = remove_cvref_t<decltype((*declval<const GraphT&>()[0].begin()).weight)>;
+
+// Queue policies. push files vertex under key; pop returns the minimum
+// (key, vertex) pair, breaking ties on the smaller vertex so every policy
+// settles vertices in the same order. A lazy policy may hand back entries
+// superseded by a later push, which the engine skips.
+template <typename D>
+class LazyBinaryHeap {
+public:
+    static constexpr bool lazy = true;
+
+    void reset(int) {
+        heap.clear();
+    }
+
+    bool empty() const {
+        return heap.empty();
+    }
+
+    size_t size() const {
+        return heap.size();
+    }
+
+    void push(int vertex, D key) {
+        heap.push_back({key, vertex});
+        push_heap(heap.begin(), heap.end(), greater<pair<D, int>>());
+    }
+
+    pair<D, int> pop() {
+        pop_heap(heap.begin(), heap.end(), greater<pair<D, int>>());
+        pair<D, int> top = heap.back();
+        heap.pop_back();
+        return top;
+    }
+
+private:
+    vector<pair<D, int>> heap;
+};
+
+// Heap over at most one entry per vertex: position[v] is v's slot or -1, so
+// pushing a queued vertex again is a true decrease-key and pops are never
+// stale. The queue never exceeds numVertices entries, and Arity children per
+// node make the tree shallower than a binary heap at the cost of a wider
+// comparison on the way down.
+template <typename D, int Arity = 4>
+class IndexedDaryHeap {
+public:
+    static constexpr bool lazy = false;
+
+    // Popped vertices already hold position -1, so only entries left behind
+    // by an abandoned search need clearing.
+    void reset(int n) {
+        for (const auto& entry : heap) {
+            position[entry.second] = -1;
+        }
+        heap.clear();
+        if (position.size() < static_cast<size_t>(n)) {
+            position.resize(n, -1);
+        }
+    }
+
+    bool empty() const {
+        return heap.empty();
+    }
+
+    size_t size() const {
+        return heap.size();
+    }
+
+    // Inserts vertex, or lowers its key if it is already queued.
+    void push(int vertex, D key) {
+        int at = position[vertex];
+        if (at == -1) {
+            at = heap.size();
+            heap.push_back({key, vertex});
+        } else {
+            heap[at].first = key;
+        }
+        sift_up(at);
+    }
+
+    pair<D, int> pop() {
+        pair<D, int> top = heap.front();
+        position[top.second] = -1;
+        pair<D, int> last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap.front() = last;
+            sift_down(0);
+        }
+        return top;
+    }
+
+private:
+    vector<pair<D, int>> heap;
+    vector<int> position;
+
+    void place(int at, const pair<D, int>& entry) {
+        heap[at] = entry;
+        position[entry.second] = at;
+    }
+
+    void sift_up(int at) {
+        pair<D, int> entry = heap[at];
+        while (at > 0) {
+            int parent = (at - 1) / Arity;
+            if (!(entry < heap[parent])) {
+                break;
+            }
+            place(at, heap[parent]);
+            at = parent;
+        }
+        place(at, entry);
+    }
+
+    void sift_down(int at) {
+        pair<D, int> entry = heap[at];
+        const int count = heap.size();
+        while (true) {
+            int first = at * Arity + 1;
+            if (first >= count) {
+                break;
+            }
+            int best = first;
+            for (int child = first + 1; child < min(first + Arity, count); ++child) {
+                if (heap[child] < heap[best]) {
+                    best = child;
+                }
+            }
+            if (!(heap[best] < entry)) {
+                break;
+            }
+            place(at, heap[best]);
+            at = best;
+        }
+        place(at, entry);
+    }
+};
+
+template <typename D>
+using IndexedQuaternaryHeap = IndexedDaryHeap<D, 4>;
+
+// Distance, previous and settled state of one search, reset in O(1). Each
+// entry carries the generation that last wrote it: stamp == generation
+// means reached, generation + 1 settled, and anything older reads as
+// unreached. begin() only advances the generation, so a search touches just
+// the vertices it reaches; the arrays are cleared only when they grow or the
+// 32-bit counter wraps.
+template <typename D>
+class SearchLabels {
+public:
+    void begin(int n) {
+        if (stamp.size() < static_cast<size_t>(n)) {
+            stamp.resize(n, 0);
+            dist.resize(n);
+            prev.resize(n);
+        }
+        count = n;
+        generation += 2;
+        if (generation == 0) {
+            fill(stamp.begin(), stamp.end(), 0);
+            generation = 2;
+        }
+    }
+
+    int size() const {
+        return count;
+    }
+
+    bool reached(int v) const {
+        return stamp[v] >= generation;
+    }
+
+    bool settled(int v) const {
+        return stamp[v] == generation + 1;
+    }
+
+    D distance(int v) const {
+        return reached(v) ? dist[v] : unreachable_distance<D>();
+    }
+
+    int previous(int v) const {
+        return reached(v) ? prev[v] : -1;
+    }
+
+    void reach(int v, D d, int parent) {
+        stamp[v] = generation;
+        dist[v] = d;
+        prev[v] = parent;
+    }
+
+    void settle(int v) {
+        stamp[v] = generation + 1;
+    }
+
+    // Dense copies of the labels; previous may be empty to skip it.
+    void copy_to(span<D> distances, span<int> previous = {}) const {
+        for (int v = 0; v < count; ++v) {
+            distances[v] = distance(v);
+        }
+        for (size_t v = 0; v < previous.size(); ++v) {
+            previous[v] = this->previous(v);
+        }
+    }
+
+private:
+    vector<uint32_t> stamp;
+    vector<D> dist;
+    vector<int> prev;
+    uint32_t generation = 0;
+    int count = 0;
+};
+
+// Runs from source, leaving the result in labels. Weights must be
+// non-negative for the result to be exact; with negative weights the search
+// still terminates, as the int engine always has.
+template <typename GraphT, typename D, typename Queue, bool Recording = false>
+void dijkstra_search(const GraphT& G, int source, SearchLabels<D>& labels, Queue& queue, StatsRecorder<Recording> stats = StatsRecorder<Recording>()) {
+    auto clock = stats.now();
+    labels.begin(G.numVertices);
+    queue.reset(G.numVertices);
+    labels.reach(source, D(), -1);
+    queue.push(source, D());
+    stats.pushed(queue.size());
+    stats.phase(&SearchStats::setup_ms, clock);
+
+    while (!queue.empty()) {
+        int u = queue.pop().second;
+        stats.popped();
+        if constexpr (Queue::lazy) {
+            if (labels.settled(u)) {
+                stats.stale();
+                continue;
+            }
+        }
+
+        labels.settle(u);
+        stats.settled();
+        const D du = labels.distance(u);
+
+        for (const auto& edge : G[u]) {
+            int v = edge.dst;
+            stats.relaxed();
+            D candidate = saturating_add(du, edge.weight);
+
+            if (!labels.settled(v) && candidate < labels.distance(v)) {
+                labels.reach(v, candidate, u);
+                queue.push(v, candidate);
+                stats.updated();
+                stats.pushed(queue.size());
+            }
+        }
+    }
+    stats.phase(&SearchStats::search_ms, clock);
+}
+
+// Everything an int dijkstra_shortest_path call would otherwise allocate:
+// the labels plus the storage of every queue policy and of the A* heap used
+// by dijkstra_point_to_point. After the first search over the largest
+// graph, searches through a workspace allocate nothing. The result stays
+// readable until the next search; use one per thread.
+struct DijkstraWorkspace {
+    SearchLabels<int> labels;
+    LazyBinaryHeap<int> heap;
+    IndexedQuaternaryHeap<int> indexed_heap;
+    vector<vector<int>> buckets;
+    LazyBinaryHeap<long long> guided_heap;
+
+    int distance(int v) const {
+        return labels.distance(v);
+    }
+
+    int previous(int v) const {
+        return labels.previous(v);
+    }
+};
+
+// Workspace forms of dijkstra_shortest_path, instantiated for Graph,
+// CsrGraph and MappedGraph. Example:
+//   DijkstraWorkspace workspace;
+//   for (int source : sources) {
+//       dijkstra_shortest_path(G, source, workspace);
+//       ... workspace.distance(target) ...
+//   }
+template <typename GraphT>
+void dijkstra_shortest_path(const GraphT& G, int source, DijkstraWorkspace& workspace, DijkstraQueue queue = DijkstraQueue::BinaryHeap);
+template <typename GraphT>
+void dijkstra_shortest_path(const GraphT& G, int source, DijkstraWorkspace& workspace, SearchStats& stats, DijkstraQueue queue = DijkstraQueue::BinaryHeap);
+
+// dijkstra_point_to_point through a workspace: the search only touches the
+// vertices it reaches, so a query costs what it settles rather than O(V).
+template <typename GraphT>
+PointToPointResult dijkstra_point_to_point(const GraphT& G, int source, int target, DijkstraWorkspace& workspace, const Landmarks* landmarks = nullptr);
+
+// Single-source distances in DistanceOf<weight type>, unreachable vertices
+// holding unreachable_distance(). Example:
+//   BasicCsrGraph<int64_t> G(graph);
+//   vector<int64_t> d = basic_dijkstra_shortest_path(G, 0, previous);
+template <template <typename> class Queue = LazyBinaryHeap, typename GraphT>
+vector<DistanceOf<WeightOf<GraphT>>> basic_dijkstra_shortest_path(const GraphT& G, int source, vector<int>& previous) {
+    using D = DistanceOf<WeightOf<GraphT>>;
+    SearchLabels<D> labels;
+    Queue<D> queue;
+    dijkstra_search(G, source, labels, queue);
+    vector<D> distance(G.numVertices);
+    previous.resize(G.numVertices);
+    labels.copy_to(span<D>(distance), span<int>(previous));
+    return distance;
+}
+
+#endif // DIJKSTRA_ENGINE_H
@@ -1,50 +1,377 @@
 #include "dijkstras.h"
+#include "dijkstra_engine.h"
 
-struct Node {
-    int vertex;
-    int weight;
-    Node(int v, int w) : vertex(v), weight(w) {}
-    bool operator>(const Node& other) const {
-        return weight > other.weight;
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+// Dial's algorithm: a circular array of maxWeight + 1 buckets indexed by
+// distance, so every live key fits without collisions and the scan for the
+// next non-empty bucket is amortized O(1) per distance value. A finished
+// search leaves every bucket empty, so the workspace keeps them, capacity
+// and all. Returns false without searching when the largest weight is
+// above MAX_BUCKET_WEIGHT, where the bucket array would not be worth its
+// memory.
+//
+// The results match the binary heap's, which settles vertices in (distance,
+// vertex) order. With positive weights a bucket is complete before it is
+// drained, so it is read front to back in O(1) per entry, and previous[v]
+// is instead kept at the tight in-neighbor with the smallest (distance, ID)
+// that the heap would have settled first. A zero-weight edge can add to the
+// bucket being drained and change which vertices are queued together, so
+// graphs that have one drain each bucket as a min-heap on vertex ID, at
+// O(log k) per pop for k same-distance entries.
+template <typename GraphT, bool Recording = false>
+static bool bucket_search(const GraphT& G, int source, SearchLabels<int>& labels, vector<vector<int>>& buckets, StatsRecorder<Recording> stats = StatsRecorder<Recording>()) {
+    auto clock = stats.now();
+    int n = G.numVertices;
+    int max_weight = 0;
+    bool zero_weights = false;
+    for (int u = 0; u < n; ++u) {
+        for (const Edge& edge : G[u]) {
+            if (edge.weight < 0) {
+                throw invalid_argument("Bucket queue requires non-negative edge weights");
+            }
+            max_weight = max(max_weight, edge.weight);
+            zero_weights = zero_weights || edge.weight == 0;
+        }
+    }
+    if (max_weight > MAX_BUCKET_WEIGHT) {
+        return false;
+    }
+    
+    labels.begin(n);
+    const size_t width = max_weight + 1;
+    if (buckets.size() < width) {
+        buckets.resize(width);
+    }
+    labels.reach(source, 0, -1);
+    buckets[0].push_back(source);
+    size_t pending = 1;
+    stats.pushed(pending);
+    stats.phase(&SearchStats::setup_ms, clock);
+    
+    auto settle = [&](int u) {
+        --pending;
+        stats.popped();
+        if (labels.settled(u)) {
+            stats.stale();
+            return;
+        }
+        
+        labels.settle(u);
+        stats.settled();
+        const int du = labels.distance(u);
+        
+        for (const Edge& edge : G[u]) {
+            int v = edge.dst;
+            int weight = edge.weight;
+            stats.relaxed();
+            
+            // A distance past INF would wrap to a negative bucket index.
+            if (du > INF - weight || labels.settled(v)) {
+                continue;
+            }
+            int dv = labels.distance(v);
+            if (du + weight < dv) {
+                labels.reach(v, du + weight, u);
+                vector<int>& target = buckets[(du + weight) % width];
+                target.push_back(v);
+                if (weight == 0) {
+                    push_heap(target.begin(), target.end(), greater<int>());
+                }
+                ++pending;
+                stats.updated();
+                stats.pushed(pending);
+            } else if (!zero_weights && du + weight == dv) {
+                int p = labels.previous(v);
+                if (labels.distance(p) == du && u < p) {
+                    labels.reach(v, dv, u);
+                }
+            }
+        }
+    };
+    
+    for (int current = 0; pending > 0; ++current) {
+        vector<int>& bucket = buckets[current % width];
+        if (!zero_weights) {
+            for (int u : bucket) {
+                settle(u);
+            }
+            bucket.clear();
+            continue;
+        }
+        
+        make_heap(bucket.begin(), bucket.end(), greater<int>());
+        while (!bucket.empty()) {
+            pop_heap(bucket.begin(), bucket.end(), greater<int>());
+            int u = bucket.back();
+            bucket.pop_back();
+            settle(u);
+        }
+    }
+    stats.phase(&SearchStats::search_ms, clock);
+    return true;
+}
+
+template <typename GraphT, bool Recording>
+static void workspace_search(const GraphT& G, int source, DijkstraWorkspace& workspace, DijkstraQueue queue, StatsRecorder<Recording> stats) {
+    if (queue == DijkstraQueue::Buckets && bucket_search(G, source, workspace.labels, workspace.buckets, stats)) {
+        return;
+    }
+    if (queue == DijkstraQueue::IndexedHeap) {
+        dijkstra_search(G, source, workspace.labels, workspace.indexed_heap, stats);
+    } else {
+        dijkstra_search(G, source, workspace.labels, workspace.heap, stats);
+    }
+}
+
+// The vector-returning overloads run in a throwaway workspace and copy the
+// labels out.
+template <typename GraphT, bool Recording>
+static vector<int> copied_shortest_path(const GraphT& G, int source, vector<int>& previous, DijkstraQueue queue, StatsRecorder<Recording> stats) {
+    DijkstraWorkspace workspace;
+    workspace_search(G, source, workspace, queue, stats);
+    vector<int> distance(G.numVertices);
+    previous.resize(G.numVertices);
+    workspace.labels.copy_to(span<int>(distance), span<int>(previous));
+    return distance;
+}
+
+vector<int> dijkstra_shortest_path(const Graph& G, int source, vector<int>& previous, DijkstraQueue queue) {
+    return copied_shortest_path(G, source, previous, queue, StatsRecorder<false>());
+}
+
+vector<int> dijkstra_shortest_path(const Graph& G, int source, vector<int>& previous, SearchStats& stats, DijkstraQueue queue) {
+    return copied_shortest_path(G, source, previous, queue, StatsRecorder<true>(&stats));
+}
+
+vector<int> dijkstra_shortest_path(const CsrGraph& G, int source, vector<int>& previous, DijkstraQueue queue) {
+    return copied_shortest_path(G, source, previous, queue, StatsRecorder<false>());
+}
+
+vector<int> dijkstra_shortest_path(const CsrGraph& G, int source, vector<int>& previous, SearchStats& stats, DijkstraQueue queue) {
+    return copied_shortest_path(G, source, previous, queue, StatsRecorder<true>(&stats));
+}
+
+vector<int> dijkstra_shortest_path(const MappedGraph& G, int source, vector<int>& previous, DijkstraQueue queue) {
+    return copied_shortest_path(G, source, previous, queue, StatsRecorder<false>());
+}
+
+vector<int> dijkstra_shortest_path(const MappedGraph& G, int source, vector<int>& previous, SearchStats& stats, DijkstraQueue queue) {
+    return copied_shortest_path(G, source, previous, queue, StatsRecorder<true>(&stats));
+}
+
+template <typename GraphT>
+void dijkstra_shortest_path(const GraphT& G, int source, DijkstraWorkspace& workspace, DijkstraQueue queue) {
+    workspace_search(G, source, workspace, queue, StatsRecorder<false>());
+}
+
+template <typename GraphT>
+void dijkstra_shortest_path(const GraphT& G, int source, DijkstraWorkspace& workspace, SearchStats& stats, DijkstraQueue queue) {
+    workspace_search(G, source, workspace, queue, StatsRecorder<true>(&stats));
+}
+
+template void dijkstra_shortest_path(const Graph& G, int source, DijkstraWorkspace& workspace, DijkstraQueue queue);
+template void dijkstra_shortest_path(const CsrGraph& G, int source, DijkstraWorkspace& workspace, DijkstraQueue queue);
+template void dijkstra_shortest_path(const MappedGraph& G, int source, DijkstraWorkspace& workspace, DijkstraQueue queue);
+template void dijkstra_shortest_path(const Graph& G, int source, DijkstraWorkspace& workspace, SearchStats& stats, DijkstraQueue queue);
+template void dijkstra_shortest_path(const CsrGraph& G, int source, DijkstraWorkspace& workspace, SearchStats& stats, DijkstraQueue queue);
+template void dijkstra_shortest_path(const MappedGraph& G, int source, DijkstraWorkspace& workspace, SearchStats& stats, DijkstraQueue queue);
+
+// Sources are claimed from an atomic counter by a pool of workers sharing
+// the read-only graph. Each worker owns one set of labels and a heap and
+// copies each result into its matrix row, so nothing O(V) is allocated per
+// source.
+template <typename GraphT>
+DistanceMatrix multi_source_shortest_paths(const GraphT& G, const vector<int>& sources, int num_threads) {
+    DistanceMatrix result;
+    result.numVertices = G.numVertices;
+    result.sources = sources;
+    result.distances.resize(sources.size() * size_t(G.numVertices));
+    
+    if (num_threads <= 0) {
+        num_threads = max(1u, thread::hardware_concurrency());
+    }
+    num_threads = min<size_t>(num_threads, max<size_t>(1, sources.size()));
+    
+    atomic<size_t> next(0);
+    auto worker = [&]() {
+        SearchLabels<int> labels;
+        LazyBinaryHeap<int> heap;
+        for (size_t i = next.fetch_add(1); i < sources.size(); i = next.fetch_add(1)) {
+            dijkstra_search(G, sources[i], labels, heap);
+            labels.copy_to(span<int>(result.distances.data() + i * G.numVertices, G.numVertices));
+        }
+    };
+    
+    vector<thread> pool;
+    for (int t = 1; t < num_threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (thread& t : pool) {
+        t.join();
     }
-};
+    return result;
+}
+
+template <typename GraphT>
+DistanceMatrix all_pairs_shortest_paths(const GraphT& G, int num_threads) {
+    vector<int> sources(G.numVertices);
+    for (int v = 0; v < G.numVertices; ++v) {
+        sources[v] = v;
+    }
+    return multi_source_shortest_paths(G, sources, num_threads);
+}
 
-vector<int> dijkstra_shortest_path(const Graph& G, int source, vector<int>& previous) {
+template DistanceMatrix multi_source_shortest_paths(const Graph& G, const vector<int>& sources, int num_threads);
+template DistanceMatrix multi_source_shortest_paths(const CsrGraph& G, const vector<int>& sources, int num_threads);
+template DistanceMatrix multi_source_shortest_paths(const MappedGraph& G, const vector<int>& sources, int num_threads);
+template DistanceMatrix all_pairs_shortest_paths(const Graph& G, int num_threads);
+template DistanceMatrix all_pairs_shortest_paths(const CsrGraph& G, int num_threads);
+template DistanceMatrix all_pairs_shortest_paths(const MappedGraph& G, int num_threads);
+
+template <typename GraphT>
+static CsrGraph reverse_graph(const GraphT& G) {
+    vector<int> srcs, dsts, weights;
+    for (int u = 0; u < G.numVertices; ++u) {
+        for (const Edge& edge : G[u]) {
+            srcs.push_back(edge.dst);
+            dsts.push_back(u);
+            weights.push_back(edge.weight);
+        }
+    }
+    return CsrGraph(G.numVertices, srcs, dsts, weights);
+}
+
+// Farthest-point selection over the vertices reachable from vertex 0: each
+// new landmark is the one farthest from every landmark chosen so far (or not
+// reached by any), which spreads landmarks toward the periphery where their
+// bounds are tightest.
+template <typename GraphT>
+Landmarks select_landmarks(const GraphT& G, int count, int num_threads) {
     int n = G.numVertices;
-    vector<int> distance(n, INF);
-    previous.resize(n, -1);
-    vector<bool> visited(n, false);
+    for (int u = 0; u < n; ++u) {
+        for (const Edge& edge : G[u]) {
+            if (edge.weight < 0) {
+                throw invalid_argument("Landmarks require non-negative edge weights");
+            }
+        }
+    }
     
-    priority_queue<Node, vector<Node>, greater<Node>> pq;
-    distance[source] = 0;
-    pq.push(Node(source, 0));
+    Landmarks landmarks;
+    if (n == 0) {
+        return landmarks;
+    }
     
-    while (!pq.empty()) {
-        Node current = pq.top();
-        pq.pop();
+    vector<int> previous;
+    vector<int> reachable = dijkstra_shortest_path(G, 0, previous);
+    vector<int> nearest = reachable;
+    for (int i = 0; i < count; ++i) {
+        int farthest = -1;
+        for (int v = 0; v < n; ++v) {
+            bool taken = find(landmarks.vertices.begin(), landmarks.vertices.end(), v) != landmarks.vertices.end();
+            if (!taken && reachable[v] != INF && (farthest == -1 || nearest[v] > nearest[farthest])) {
+                farthest = v;
+            }
+        }
+        if (farthest == -1) {
+            break;
+        }
+        landmarks.vertices.push_back(farthest);
         
-        int u = current.vertex;
-        if (visited[u]) {
+        vector<int> distance = dijkstra_shortest_path(G, farthest, previous);
+        for (int v = 0; v < n; ++v) {
+            nearest[v] = i == 0 ? distance[v] : min(nearest[v], distance[v]);
+        }
+    }
+    
+    landmarks.from = multi_source_shortest_paths(G, landmarks.vertices, num_threads);
+    landmarks.to = multi_source_shortest_paths(reverse_graph(G), landmarks.vertices, num_threads);
+    return landmarks;
+}
+
+// A* keys are the distance plus the ALT bound, which may pass INF, so the
+// workspace keeps a separate long long heap for them.
+template <typename GraphT>
+PointToPointResult dijkstra_point_to_point(const GraphT& G, int source, int target, DijkstraWorkspace& workspace, const Landmarks* landmarks) {
+    SearchLabels<int>& labels = workspace.labels;
+    LazyBinaryHeap<long long>& queue = workspace.guided_heap;
+    labels.begin(G.numVertices);
+    queue.reset(G.numVertices);
+    
+    int landmark_count = landmarks == nullptr ? 0 : landmarks->vertices.size();
+    auto alt_bound = [&](int v) {
+        int bound = 0;
+        for (int i = 0; i < landmark_count; ++i) {
+            int from_v = landmarks->from.at(i, v);
+            int from_t = landmarks->from.at(i, target);
+            if (from_v != INF && from_t != INF) {
+                bound = max(bound, from_t - from_v);
+            }
+            int v_to = landmarks->to.at(i, v);
+            int t_to = landmarks->to.at(i, target);
+            if (v_to != INF && t_to != INF) {
+                bound = max(bound, v_to - t_to);
+            }
+        }
+        return bound;
+    };
+    
+    PointToPointResult result;
+    labels.reach(source, 0, -1);
+    queue.push(source, alt_bound(source));
+    
+    while (!queue.empty()) {
+        int u = queue.pop().second;
+        if (labels.settled(u)) {
             continue;
         }
+        labels.settle(u);
+        ++result.settled;
         
-        visited[u] = true;
+        if (u == target) {
+            break;
+        }
         
+        const int du = labels.distance(u);
         for (const Edge& edge : G[u]) {
             int v = edge.dst;
-            int weight = edge.weight;
-            
-            if (!visited[v] && distance[u] != INF && distance[u] + weight < distance[v]) {
-                distance[v] = distance[u] + weight;
-                previous[v] = u;
-                pq.push(Node(v, distance[v]));
+            int candidate = saturating_add(du, edge.weight);
+            if (!labels.settled(v) && candidate < labels.distance(v)) {
+                labels.reach(v, candidate, u);
+                queue.push(v, static_cast<long long>(candidate) + alt_bound(v));
             }
         }
     }
     
-    return distance;
+    if (labels.settled(target)) {
+        result.cost = labels.distance(target);
+        for (int at = target; at != -1; at = labels.previous(at)) {
+            result.path.push_back(at);
+        }
+        reverse(result.path.begin(), result.path.end());
+    }
+    return result;
+}
+
+template <typename GraphT>
+PointToPointResult dijkstra_point_to_point(const GraphT& G, int source, int target, const Landmarks* landmarks) {
+    DijkstraWorkspace workspace;
+    return dijkstra_point_to_point(G, source, target, workspace, landmarks);
 }
 
+template Landmarks select_landmarks(const Graph& G, int count, int num_threads);
+template Landmarks select_landmarks(const CsrGraph& G, int count, int num_threads);
+template Landmarks select_landmarks(const MappedGraph& G, int count, int num_threads);
+template PointToPointResult dijkstra_point_to_point(const Graph& G, int source, int target, const Landmarks* landmarks);
+template PointToPointResult dijkstra_point_to_point(const CsrGraph& G, int source, int target, const Landmarks* landmarks);
+template PointToPointResult dijkstra_point_to_point(const MappedGraph& G, int source, int target, const Landmarks* landmarks);
+template PointToPointResult dijkstra_point_to_point(const Graph& G, int source, int target, DijkstraWorkspace& workspace, const Landmarks* landmarks);
+template PointToPointResult dijkstra_point_to_point(const CsrGraph& G, int source, int target, DijkstraWorkspace& workspace, const Landmarks* landmarks);
+template PointToPointResult dijkstra_point_to_point(const MappedGraph& G, int source, int target, DijkstraWorkspace& workspace, const Landmarks* landmarks);
+
 vector<int> extract_shortest_path(const vector<int>& distances, const vector<int>& previous, int destination) {
     vector<int> path;
     if (distances[destination] == INF) {
@@ -76,4 +403,73 @@ void print_path(const vector<int>& path, int total) {
         }
     }
     cout << " \nTotal cost is " << total << "\n";
-}
\ No newline at end of file
+}
+
+static size_t decimal_length(unsigned value) {
+    size_t length = 1;
+    while (value >= 10) {
+        value /= 10;
+        ++length;
+    }
+    return length;
+}
+
+static char* write_decimal_backward(char* end, unsigned value) {
+    do {
+        *--end = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    return end;
+}
+
+void write_shortest_path(OutputBuffer& out, span<const int> distances, span<const int> previous, int source, int destination, PathFormat format) {
+    int cost = distances[destination];
+    size_t vertices = 0;
+    size_t digits = 0;
+    if (cost != INF) {
+        for (int at = destination; at != -1; at = previous[at]) {
+            ++vertices;
+            digits += decimal_length(at);
+        }
+    }
+    
+    if (format == PathFormat::Binary) {
+        int32_t header[4] = {source, destination, cost, static_cast<int32_t>(vertices)};
+        memcpy(out.claim(sizeof(header)), header, sizeof(header));
+        int32_t* end = reinterpret_cast<int32_t*>(out.claim(vertices * sizeof(int32_t))) + vertices;
+        for (int at = vertices > 0 ? destination : -1; at != -1; at = previous[at]) {
+            int32_t vertex = at;
+            memcpy(--end, &vertex, sizeof(vertex));
+        }
+        return;
+    }
+    
+    if (format == PathFormat::Csv) {
+        out.write_int(source);
+        out.put(',');
+        out.write_int(destination);
+        out.put(',');
+        if (cost != INF) {
+            out.write_int(cost);
+        }
+        out.put(',');
+    }
+    
+    // Text ends every vertex with a space; CSV only separates them.
+    size_t separators = format == PathFormat::Text ? vertices : max<size_t>(vertices, 1) - 1;
+    char* end = out.claim(digits + separators) + digits + separators;
+    bool space_after = format == PathFormat::Text;
+    for (int at = vertices > 0 ? destination : -1; at != -1; at = previous[at]) {
+        if (space_after) {
+            *--end = ' ';
+        }
+        end = write_decimal_backward(end, at);
+        space_after = true;
+    }
+    
+    if (format == PathFormat::Text) {
+        out.write("\nTotal cost is ");
+        out.write_int(cost);
+    }
+    out.put('\n');
+}
@@ -9,57 +9,325 @@
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
+#include <span>
+#include <memory>
+#include <utility>
+
+#include "graph_io.h"
+#include "search_stats.h"
+#include "edge_arena.h"
 
 using namespace std;
 
 const int INF = numeric_limits<int>::max();
 
+// Priority queue used by dijkstra_shortest_path. Buckets (Dial's algorithm)
+// needs non-negative weights and suits graphs whose weights are small ints;
+// it keeps one bucket per weight value, so graphs with a weight above
+// MAX_BUCKET_WEIGHT run on the binary heap instead, with the same result.
+// IndexedHeap is a 4-ary heap with decrease-key, holding at most one entry
+// per vertex instead of one per successful relaxation.
+enum class DijkstraQueue {
+    BinaryHeap,
+    Buckets,
+    IndexedHeap
+};
+
+const int MAX_BUCKET_WEIGHT = 1 << 20;
+
 struct Edge {
     int dst;
     int weight;
     Edge(int d, int w) : dst(d), weight(w) {}
 };
 
+// Out-edges of one vertex, allocated from the owning Graph's arena.
+using EdgeList = pmr::vector<Edge>;
+
+// Adjacency lists that all live in one EdgeArena owned by the graph.
+// Building a graph takes a few large blocks instead of an allocation per
+// vertex and per regrowth, and destroying it hands those blocks back in one
+// go. Lists sized up front (as file_to_graph does) fill the arena without
+// gaps. A moved-from graph has no vertices.
 struct Graph {
     int numVertices;
-    vector<vector<Edge>> adjacencyList;
     
     Graph() : numVertices(0) {}
+    // n vertices without edges, with arena space for the given edge count.
+    Graph(int n, size_t edges);
+    Graph(const Graph& other);
+    Graph(Graph&& other) noexcept : numVertices(exchange(other.numVertices, 0)), storage(std::move(other.storage)) {}
+    Graph& operator=(const Graph& other);
+    Graph& operator=(Graph&& other) noexcept {
+        numVertices = exchange(other.numVertices, 0);
+        storage = std::move(other.storage);
+        return *this;
+    }
     
-    void resize(int n) {
-        numVertices = n;
-        adjacencyList.resize(n);
+    void resize(int n);
+    
+    void add_edge(int src, int dst, int weight) {
+        storage->lists[src].emplace_back(dst, weight);
     }
     
-    const vector<Edge>& operator[](int index) const {
-        return adjacencyList[index];
+    long long numEdges() const;
+    
+    const EdgeList& operator[](int index) const {
+        return storage->lists[index];
     }
     
-    vector<Edge>& operator[](int index) {
-        return adjacencyList[index];
+    EdgeList& operator[](int index) {
+        return storage->lists[index];
     }
+    
+private:
+    // Kept behind a pointer so the lists' arena stays put when the graph
+    // is moved.
+    struct Storage {
+        EdgeArena arena;
+        pmr::vector<EdgeList> lists;
+        
+        explicit Storage(size_t bytes) : arena(bytes), lists(&arena) {}
+    };
+    unique_ptr<Storage> storage;
 };
 
+inline istream& operator>>(istream& in, Graph& G) {
+    int n;
+    if (!(in >> n)) {
+        throw runtime_error("Missing vertex count in graph input");
+    }
+    
+    G.resize(n);
+    
+    int src, dst, weight;
+    while (in >> src >> dst >> weight) {
+        G.add_edge(src, dst, weight);
+    }
+    return in;
+}
+
 inline void file_to_graph(const string& filename, Graph& G) {
-    ifstream file(filename);
-    if (!file) {
-        throw runtime_error("Cannot open graph file: " + filename);
+    MappedFile file(filename, "graph file");
+    parse_graph_text(file.data(), file.size(), filename, G);
+}
+
+// Frozen compressed-sparse-row form of a Graph. The out-edges of u are
+// dsts/weights[offsets[u], offsets[u + 1]), in the same order as in the
+// adjacency list, so every engine produces the same results on both forms.
+struct CsrGraph {
+    int numVertices;
+    vector<int> offsets;
+    vector<int> dsts;
+    vector<int> weights;
+    
+    struct EdgeRange {
+        const int* dst;
+        const int* weight;
+        int count;
+        
+        struct iterator {
+            const int* dst;
+            const int* weight;
+            Edge operator*() const {
+                return Edge(*dst, *weight);
+            }
+            iterator& operator++() {
+                ++dst;
+                ++weight;
+                return *this;
+            }
+            bool operator!=(const iterator& other) const {
+                return dst != other.dst;
+            }
+        };
+        
+        iterator begin() const {
+            return {dst, weight};
+        }
+        
+        iterator end() const {
+            return {dst + count, weight + count};
+        }
+        
+        int size() const {
+            return count;
+        }
+    };
+    
+    CsrGraph() : numVertices(0), offsets(1, 0) {}
+    
+    explicit CsrGraph(const Graph& G) : numVertices(G.numVertices), offsets(G.numVertices + 1, 0) {
+        for (int u = 0; u < numVertices; ++u) {
+            offsets[u + 1] = offsets[u] + G[u].size();
+        }
+        dsts.reserve(offsets.back());
+        weights.reserve(offsets.back());
+        for (int u = 0; u < numVertices; ++u) {
+            for (const Edge& edge : G[u]) {
+                dsts.push_back(edge.dst);
+                weights.push_back(edge.weight);
+            }
+        }
     }
     
-    int n, m;
-    file >> n >> m;
+    // Builds from parallel edge arrays with a counting sort on the source,
+    // which keeps each vertex's edges in input order.
+    CsrGraph(int n, const vector<int>& srcs, const vector<int>& edge_dsts, const vector<int>& edge_weights)
+        : numVertices(n), offsets(n + 1, 0), dsts(srcs.size()), weights(srcs.size()) {
+        for (int src : srcs) {
+            ++offsets[src + 1];
+        }
+        for (int u = 0; u < n; ++u) {
+            offsets[u + 1] += offsets[u];
+        }
+        vector<int> next(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < srcs.size(); ++i) {
+            int slot = next[srcs[i]]++;
+            dsts[slot] = edge_dsts[i];
+            weights[slot] = edge_weights[i];
+        }
+    }
     
-    G.resize(n);
+    int numEdges() const {
+        return dsts.size();
+    }
+    
+    EdgeRange operator[](int index) const {
+        return {dsts.data() + offsets[index], weights.data() + offsets[index], offsets[index + 1] - offsets[index]};
+    }
+};
+
+inline istream& operator>>(istream& in, CsrGraph& G) {
+    int n;
+    if (!(in >> n)) {
+        throw runtime_error("Missing vertex count in graph input");
+    }
     
-    for (int i = 0; i < m; ++i) {
-        int src, dst, weight;
-        file >> src >> dst >> weight;
-        G[src].push_back(Edge(dst, weight));
+    vector<int> srcs, dsts, weights;
+    int src, dst, weight;
+    while (in >> src >> dst >> weight) {
+        srcs.push_back(src);
+        dsts.push_back(dst);
+        weights.push_back(weight);
     }
+    
+    G = CsrGraph(n, srcs, dsts, weights);
+    return in;
+}
+
+inline void file_to_graph(const string& filename, CsrGraph& G) {
+    MappedFile file(filename, "graph file");
+    parse_graph_text(file.data(), file.size(), filename, G);
 }
 
-vector<int> dijkstra_shortest_path(const Graph& G, int source, vector<int>& previous);
+// Read-only graph backed by a memory-mapped binary graph file (see
+// save_graph_binary). The CSR blocks are used in place, with no per-edge
+// parsing or copying.
+struct MappedGraph {
+    int numVertices;
+    MappedFile file;
+    const int* offsets;
+    const int* dsts;
+    const int* weights;
+    
+    explicit MappedGraph(const string& filename);
+    
+    int numEdges() const {
+        return offsets[numVertices];
+    }
+    
+    CsrGraph::EdgeRange operator[](int index) const {
+        return {dsts + offsets[index], weights + offsets[index], offsets[index + 1] - offsets[index]};
+    }
+};
+
+vector<int> dijkstra_shortest_path(const Graph& G, int source, vector<int>& previous, DijkstraQueue queue = DijkstraQueue::BinaryHeap);
+vector<int> dijkstra_shortest_path(const CsrGraph& G, int source, vector<int>& previous, DijkstraQueue queue = DijkstraQueue::BinaryHeap);
+vector<int> dijkstra_shortest_path(const MappedGraph& G, int source, vector<int>& previous, DijkstraQueue queue = DijkstraQueue::BinaryHeap);
+// Same search, also accumulating counters and phase timings into stats.
+vector<int> dijkstra_shortest_path(const Graph& G, int source, vector<int>& previous, SearchStats& stats, DijkstraQueue queue = DijkstraQueue::BinaryHeap);
+vector<int> dijkstra_shortest_path(const CsrGraph& G, int source, vector<int>& previous, SearchStats& stats, DijkstraQueue queue = DijkstraQueue::BinaryHeap);
+vector<int> dijkstra_shortest_path(const MappedGraph& G, int source, vector<int>& previous, SearchStats& stats, DijkstraQueue queue = DijkstraQueue::BinaryHeap);
+
+// Row-major |sources| x numVertices distances; row i belongs to sources[i].
+struct DistanceMatrix {
+    int numVertices = 0;
+    vector<int> sources;
+    vector<int> distances;
+    
+    int at(int row, int vertex) const {
+        return distances[size_t(row) * numVertices + vertex];
+    }
+    
+    span<const int> row(int index) const {
+        return span<const int>(distances.data() + size_t(index) * numVertices, numVertices);
+    }
+};
+
+// Binary-heap Dijkstra from every source on num_threads workers (0 means
+// one per hardware thread). Instantiated for Graph, CsrGraph and MappedGraph.
+template <typename GraphT>
+DistanceMatrix multi_source_shortest_paths(const GraphT& G, const vector<int>& sources, int num_threads = 0);
+template <typename GraphT>
+DistanceMatrix all_pairs_shortest_paths(const GraphT& G, int num_threads = 0);
+
+// A few landmark vertices with exact distances to and from every vertex.
+// For any s, t and landmark L the triangle inequality gives
+// d(s, t) >= d(L, t) - d(L, s) and d(s, t) >= d(s, L) - d(t, L), an
+// admissible and consistent A* heuristic (ALT). Requires non-negative
+// weights.
+struct Landmarks {
+    vector<int> vertices;
+    DistanceMatrix from;
+    DistanceMatrix to;
+};
+
+template <typename GraphT>
+Landmarks select_landmarks(const GraphT& G, int count, int num_threads = 0);
+
+struct PointToPointResult {
+    int cost = INF;
+    vector<int> path;
+    int settled = 0;
+};
+
+// Single-pair query that stops once target is settled. With landmarks it
+// runs A* guided by the ALT bound; the cost always equals the full run's
+// distance for non-negative weights. path is empty when target is
+// unreachable.
+template <typename GraphT>
+PointToPointResult dijkstra_point_to_point(const GraphT& G, int source, int target, const Landmarks* landmarks = nullptr);
+
+// Parallel delta-stepping SSSP on num_threads workers (0 means one per
+// hardware thread). Vertices are bucketed by floor(distance / delta); edges
+// of weight <= delta are relaxed repeatedly within a bucket, heavier ones
+// once per bucket. delta <= 0 picks maxWeight / averageDegree, and a delta
+// too small for the heaviest edge is raised to bound the bucket count.
+// Distances equal dijkstra_shortest_path's; previous is a valid
+// shortest-path tree but may break ties differently. Requires non-negative
+// weights.
+template <typename GraphT>
+vector<int> delta_stepping_shortest_path(const GraphT& G, int source, vector<int>& previous, int delta = 0, int num_threads = 0);
+
 vector<int> extract_shortest_path(const vector<int>& distances, const vector<int>& previous, int destination);
 void print_path(const vector<int>& path, int total);
 
+// Record layouts for write_shortest_path:
+//   Text    print_path's two lines, "v0 v1 ... vk \nTotal cost is c\n"
+//   Csv     "source,destination,cost,v0 v1 ... vk"; cost and path are empty
+//           when destination is unreachable
+//   Binary  int32 source, destination, cost (INF if unreachable), vertex
+//           count k + 1, then the k + 1 int32 vertices, native byte order
+enum class PathFormat {
+    Text,
+    Csv,
+    Binary
+};
+
+// Streams the path to destination straight from the previous array: the
+// chain is walked once to size the record and once more to fill it back to
+// front, so nothing is allocated per destination.
+void write_shortest_path(OutputBuffer& out, span<const int> distances, span<const int> previous, int source, int destination, PathFormat format);
+
 #endif // DIJKSTRAS_H
\ No newline at end of file
@@ -1,28 +1,171 @@
 #include "dijkstras.h"
+#include "dijkstra_engine.h"
 
-int main() {
+#include <unistd.h>
+
+struct PathQuery {
+    vector<int> sources = {0};
+    vector<int> destinations;   // empty means every vertex
+    PathFormat format = PathFormat::Text;
+    DijkstraQueue queue = DijkstraQueue::BinaryHeap;
+    bool show_stats = false;
+};
+
+static vector<int> parse_vertex_list(const string& text) {
+    vector<int> vertices;
+    stringstream in(text);
+    string item;
+    while (getline(in, item, ',')) {
+        size_t used = 0;
+        int vertex = stoi(item, &used);
+        if (used != item.size()) {
+            throw invalid_argument("Bad vertex list: " + text);
+        }
+        vertices.push_back(vertex);
+    }
+    return vertices;
+}
+
+static PathFormat parse_format(const string& name) {
+    if (name == "text") {
+        return PathFormat::Text;
+    }
+    if (name == "csv") {
+        return PathFormat::Csv;
+    }
+    if (name == "binary") {
+        return PathFormat::Binary;
+    }
+    throw invalid_argument("Unknown output format: " + name);
+}
+
+static DijkstraQueue parse_queue(const string& name) {
+    if (name == "heap") {
+        return DijkstraQueue::BinaryHeap;
+    }
+    if (name == "buckets") {
+        return DijkstraQueue::Buckets;
+    }
+    if (name == "indexed") {
+        return DijkstraQueue::IndexedHeap;
+    }
+    throw invalid_argument("Unknown queue: " + name);
+}
+
+template <typename GraphT>
+static void write_all_paths(const GraphT& G, const PathQuery& query, OutputBuffer& out) {
+    for (const vector<int>* list : {&query.sources, &query.destinations}) {
+        for (int v : *list) {
+            if (v < 0 || v >= G.numVertices) {
+                throw out_of_range("Vertex " + to_string(v) + " out of range [0, " + to_string(G.numVertices) + ")");
+            }
+        }
+    }
+
+    if (query.format == PathFormat::Csv) {
+        out.write("source,destination,cost,path\n");
+    }
+
+    // One workspace and one pair of dense arrays serve every source.
+    SearchStats stats;
+    DijkstraWorkspace workspace;
+    vector<int> distances(G.numVertices);
+    vector<int> previous(G.numVertices);
+    for (int source : query.sources) {
+        if (query.show_stats) {
+            dijkstra_shortest_path(G, source, workspace, stats, query.queue);
+        } else {
+            dijkstra_shortest_path(G, source, workspace, query.queue);
+        }
+        workspace.labels.copy_to(span<int>(distances), span<int>(previous));
+
+        if (query.format == PathFormat::Text) {
+            out.write("Shortest paths from vertex ");
+            out.write_int(source);
+            out.write(":\n");
+        }
+        if (query.destinations.empty()) {
+            for (int dest = 0; dest < G.numVertices; ++dest) {
+                write_shortest_path(out, distances, previous, source, dest, query.format);
+            }
+        } else {
+            for (int dest : query.destinations) {
+                write_shortest_path(out, distances, previous, source, dest, query.format);
+            }
+        }
+    }
+    out.flush();
+
+    if (query.show_stats) {
+        print_search_stats(stats);
+    }
+}
+
+// Usage:
+//   dijkstra_main [--graph FILE] [--source S[,S...]] [--dest D[,D...]]
+//                 [--format text|csv|binary] [--output FILE]
+//                 [--queue heap|buckets|indexed] [--stats]
+//   dijkstra_main --convert text_file binary_file
+// Without --graph, prompts for the file name. Text and binary graphs are
+// both accepted. Sources default to 0 and destinations to every vertex;
+// --stats prints search counters to stderr.
+int main(int argc, char* argv[]) {
     try {
+        if (argc == 4 && string(argv[1]) == "--convert") {
+            CsrGraph G;
+            file_to_graph(argv[2], G);
+            save_graph_binary(G, argv[3]);
+            return 0;
+        }
+
+        PathQuery query;
         string filename;
-        cout << "Enter graph file name: ";
-        cin >> filename;
-        
-        Graph G;
-        file_to_graph(filename, G);
-        
-        const int source = 0;
-        vector<int> previous;
-        vector<int> distances = dijkstra_shortest_path(G, source, previous);
-        
-        cout << "Shortest paths from vertex " << source << ":" << endl;
-        for (int dest = 0; dest < G.numVertices; ++dest) {
-            vector<int> path = extract_shortest_path(distances, previous, dest);
-            print_path(path, distances[dest]);
+        string output;
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            if (arg == "--stats") {
+                query.show_stats = true;
+                continue;
+            }
+            if (i + 1 >= argc) {
+                throw runtime_error("Missing value for " + arg);
+            }
+            string value = argv[++i];
+            if (arg == "--graph") {
+                filename = value;
+            } else if (arg == "--source") {
+                query.sources = parse_vertex_list(value);
+            } else if (arg == "--dest") {
+                query.destinations = parse_vertex_list(value);
+            } else if (arg == "--format") {
+                query.format = parse_format(value);
+            } else if (arg == "--output") {
+                output = value;
+            } else if (arg == "--queue") {
+                query.queue = parse_queue(value);
+            } else {
+                throw runtime_error("Unknown argument: " + arg + " " + value);
+            }
+        }
+
+        if (filename.empty()) {
+            cout << "Enter graph file name: " << flush;
+            cin >> filename;
+        }
+
+        OutputBuffer out = output.empty() ? OutputBuffer(STDOUT_FILENO) : OutputBuffer(output);
+        if (is_graph_binary(filename)) {
+            write_all_paths(MappedGraph(filename), query, out);
+        } else {
+            CsrGraph G;
+            file_to_graph(filename, G);
+            write_all_paths(G, query, out);
         }
     }
     catch (const exception& e) {
         cerr << "Error: " << e.what() << endl;
         return 1;
     }
-    
+
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,59 @@
+#ifndef EDGE_ARENA_H
+#define EDGE_ARENA_H
+
+#include <memory_resource>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+using namespace std;
+
+// Monotonic arena for adjacency storage. Memory is carved from a few
+// geometrically growing blocks and only returned, in bulk, when the arena
+// is destroyed. Growing a vector doubles its capacity, so the buffers it
+// frees have power-of-two sizes; those go on a free list per size and the
+// next list growing through that size reuses them. Any other freed buffer
+// stays unused until the arena goes away. Not thread-safe.
+class EdgeArena : public pmr::memory_resource {
+public:
+    explicit EdgeArena(size_t initial_bytes) : blocks(max(initial_bytes, size_t(1024))) {}
+
+private:
+    pmr::monotonic_buffer_resource blocks;
+    array<void*, 64> free_lists = {};
+
+    static bool recyclable(size_t bytes, size_t alignment) {
+        return has_single_bit(bytes) && bytes >= sizeof(void*) && alignment <= alignof(max_align_t);
+    }
+
+    // Freed buffers may be less aligned than a pointer, so the link to the
+    // next one is copied in and out rather than stored through a cast.
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        if (recyclable(bytes, alignment)) {
+            void*& head = free_lists[countr_zero(bytes)];
+            if (head && reinterpret_cast<uintptr_t>(head) % alignment == 0) {
+                void* block = head;
+                memcpy(&head, block, sizeof(void*));
+                return block;
+            }
+        }
+        return blocks.allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* block, size_t bytes, size_t alignment) override {
+        if (recyclable(bytes, alignment)) {
+            void*& head = free_lists[countr_zero(bytes)];
+            memcpy(block, &head, sizeof(void*));
+            head = block;
+        }
+    }
+
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+#endif // EDGE_ARENA_H
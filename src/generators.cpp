@@ -0,0 +1,150 @@
+#include "generators.h"
+
+#include <random>
+#include <unordered_set>
+
+CsrGraph generate_random_graph(int n, long long m, int max_weight, uint64_t seed) {
+    mt19937_64 rng(seed);
+    uniform_int_distribution<int> vertex(0, n - 1);
+    uniform_int_distribution<int> weight(1, max_weight);
+
+    vector<int> srcs(m), dsts(m), weights(m);
+    for (long long i = 0; i < m; ++i) {
+        srcs[i] = vertex(rng);
+        dsts[i] = vertex(rng);
+        weights[i] = weight(rng);
+    }
+    return CsrGraph(n, srcs, dsts, weights);
+}
+
+CsrGraph generate_grid_graph(int side, int max_weight, uint64_t seed) {
+    mt19937_64 rng(seed);
+    uniform_int_distribution<int> weight(1, max_weight);
+
+    vector<int> srcs, dsts, weights;
+    auto add = [&](int u, int v) {
+        srcs.push_back(u);
+        dsts.push_back(v);
+        weights.push_back(weight(rng));
+    };
+    for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+            int u = r * side + c;
+            if (c + 1 < side) {
+                add(u, u + 1);
+                add(u + 1, u);
+            }
+            if (r + 1 < side) {
+                add(u, u + side);
+                add(u + side, u);
+            }
+        }
+    }
+    return CsrGraph(side * side, srcs, dsts, weights);
+}
+
+CsrGraph generate_power_law_graph(int n, int edges_per_vertex, int max_weight, uint64_t seed) {
+    mt19937_64 rng(seed);
+    uniform_int_distribution<int> weight(1, max_weight);
+
+    // Every edge endpoint is recorded once, so a uniform pick from this list
+    // is a pick proportional to degree.
+    vector<int> endpoints = {0};
+    vector<int> srcs, dsts, weights;
+    for (int v = 1; v < n; ++v) {
+        int links = min(v, edges_per_vertex);
+        for (int k = 0; k < links; ++k) {
+            int target = endpoints[uniform_int_distribution<size_t>(0, endpoints.size() - 1)(rng)];
+            srcs.push_back(v);
+            dsts.push_back(target);
+            weights.push_back(weight(rng));
+            srcs.push_back(target);
+            dsts.push_back(v);
+            weights.push_back(weight(rng));
+            endpoints.push_back(target);
+        }
+        endpoints.push_back(v);
+    }
+    return CsrGraph(n, srcs, dsts, weights);
+}
+
+void write_graph_text(const CsrGraph& G, const string& filename) {
+    ofstream out(filename);
+    if (!out) {
+        throw runtime_error("Cannot create graph file: " + filename);
+    }
+
+    string buffer;
+    buffer.reserve(1 << 20);
+    buffer += to_string(G.numVertices) + "\n";
+    for (int u = 0; u < G.numVertices; ++u) {
+        for (const Edge& edge : G[u]) {
+            buffer += to_string(u);
+            buffer += ' ';
+            buffer += to_string(edge.dst);
+            buffer += ' ';
+            buffer += to_string(edge.weight);
+            buffer += '\n';
+        }
+        if (buffer.size() > (1 << 20) - 64) {
+            out << buffer;
+            buffer.clear();
+        }
+    }
+    out << buffer;
+}
+
+vector<string> generate_dictionary(int count, uint64_t seed) {
+    mt19937_64 rng(seed);
+    uniform_int_distribution<int> letter('a', 'z');
+
+    vector<string> words;
+    unordered_set<string> seen;
+    auto add = [&](const string& word) {
+        if (!word.empty() && seen.insert(word).second) {
+            words.push_back(word);
+        }
+    };
+
+    for (int root = 0; root < max(1, count / 1000); ++root) {
+        string word(3 + rng() % 5, 'a');
+        for (char& c : word) {
+            c = letter(rng);
+        }
+        add(word);
+    }
+
+    while (static_cast<int>(words.size()) < count) {
+        string word = words[uniform_int_distribution<size_t>(0, words.size() - 1)(rng)];
+        size_t position = uniform_int_distribution<size_t>(0, word.size())(rng);
+        switch (rng() % 3) {
+        case 0:
+            if (position < word.size()) {
+                word[position] = letter(rng);
+            }
+            break;
+        case 1:
+            if (word.size() < 12) {
+                word.insert(word.begin() + position, letter(rng));
+            }
+            break;
+        default:
+            if (position < word.size() && word.size() > 2) {
+                word.erase(word.begin() + position);
+            }
+            break;
+        }
+        add(word);
+    }
+    return words;
+}
+
+void write_words(const vector<string>& words, const string& filename) {
+    ofstream out(filename);
+    if (!out) {
+        throw runtime_error("Cannot create word file: " + filename);
+    }
+    for (const string& word : words) {
+        out << word << '\n';
+    }
+}
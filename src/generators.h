@@ -0,0 +1,37 @@
+#ifndef GENERATORS_H
+#define GENERATORS_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "dijkstras.h"
+
+using namespace std;
+
+// Seeded synthetic workloads for benchmarks and tests. The same arguments
+// always produce the same graph or word list.
+
+// m edges with uniformly random endpoints and weights in [1, max_weight].
+CsrGraph generate_random_graph(int n, long long m, int max_weight, uint64_t seed);
+
+// side x side grid with an edge each way between 4-neighbors, weights in
+// [1, max_weight].
+CsrGraph generate_grid_graph(int side, int max_weight, uint64_t seed);
+
+// Preferential attachment: each new vertex links to edges_per_vertex
+// existing vertices chosen proportionally to degree (both directions), which
+// gives a power-law degree distribution.
+CsrGraph generate_power_law_graph(int n, int edges_per_vertex, int max_weight, uint64_t seed);
+
+// Writes the "n" header and one "src dst weight" line per edge, the format
+// read by file_to_graph.
+void write_graph_text(const CsrGraph& G, const string& filename);
+
+// count distinct lowercase words grown by single-letter edits from a few
+// random roots, so most pairs are joined by ladders.
+vector<string> generate_dictionary(int count, uint64_t seed);
+
+void write_words(const vector<string>& words, const string& filename);
+
+#endif // GENERATORS_H
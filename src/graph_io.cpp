@@ -0,0 +1,376 @@
+#include "graph_io.h"
+#include "dijkstras.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <charconv>
+#include <cerrno>
+#include <cstring>
+
+static int madvise_advice(MappedAccess access) {
+    switch (access) {
+    case MappedAccess::Sequential:
+        return MADV_SEQUENTIAL;
+    case MappedAccess::Random:
+        return MADV_RANDOM;
+    default:
+        return MADV_NORMAL;
+    }
+}
+
+MappedFile::MappedFile(const string& filename, const string& kind, MappedAccess access) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw runtime_error("Cannot open " + kind + ": " + filename);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw runtime_error("Cannot stat " + kind + ": " + filename);
+    }
+
+    length = info.st_size;
+    if (length > 0) {
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close(fd);
+            throw runtime_error("Cannot map " + kind + ": " + filename);
+        }
+        begin = static_cast<const char*>(mapped);
+        madvise(mapped, length, madvise_advice(access));
+    }
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (begin != nullptr) {
+        munmap(const_cast<char*>(begin), length);
+    }
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept : begin(other.begin), length(other.length) {
+    other.begin = nullptr;
+    other.length = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    swap(begin, other.begin);
+    swap(length, other.length);
+    return *this;
+}
+
+OutputBuffer::OutputBuffer(int fd, size_t capacity) : fd(fd), buffer(capacity) {}
+
+OutputBuffer::OutputBuffer(const string& filename, size_t capacity) : buffer(capacity) {
+    fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw runtime_error("Cannot create output file: " + filename);
+    }
+    owns_fd = true;
+}
+
+// Errors cannot be thrown from here; callers that care flush() first.
+OutputBuffer::~OutputBuffer() {
+    try {
+        flush();
+    } catch (const exception&) {
+    }
+    if (owns_fd) {
+        close(fd);
+    }
+}
+
+void OutputBuffer::write(string_view text) {
+    if (used + text.size() > buffer.size()) {
+        flush();
+    }
+    if (text.size() > buffer.size()) {
+        buffer.resize(text.size());
+    }
+    memcpy(buffer.data() + used, text.data(), text.size());
+    used += text.size();
+}
+
+void OutputBuffer::write_int(long long value) {
+    char digits[24];
+    auto result = to_chars(digits, digits + sizeof(digits), value);
+    write(string_view(digits, result.ptr - digits));
+}
+
+char* OutputBuffer::claim(size_t size) {
+    if (used + size > buffer.size()) {
+        flush();
+    }
+    if (size > buffer.size()) {
+        buffer.resize(size);
+    }
+    char* at = buffer.data() + used;
+    used += size;
+    return at;
+}
+
+void OutputBuffer::flush() {
+    size_t done = 0;
+    while (done < used) {
+        ssize_t written = ::write(fd, buffer.data() + done, used - done);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            used = 0;
+            throw runtime_error(string("Cannot write output: ") + strerror(errno));
+        }
+        done += written;
+    }
+    used = 0;
+}
+
+// Hand-rolled scanner over the mapped text: no locale, no stream state, one
+// pass over the bytes.
+struct GraphTextScanner {
+    const char* p;
+    const char* end;
+    const string& filename;
+    int line = 1;
+
+    [[noreturn]] void fail(const string& problem) const {
+        throw runtime_error(filename + ":" + to_string(line) + ": " + problem);
+    }
+
+    void skip_blanks() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+            ++p;
+        }
+    }
+
+    // Skips blank lines; returns false at end of input.
+    bool next_line() {
+        for (;;) {
+            skip_blanks();
+            if (p == end) {
+                return false;
+            }
+            if (*p != '\n') {
+                return true;
+            }
+            ++p;
+            ++line;
+        }
+    }
+
+    void end_line() {
+        skip_blanks();
+        if (p < end && *p != '\n') {
+            fail("unexpected trailing characters");
+        }
+        if (p < end) {
+            ++p;
+            ++line;
+        }
+    }
+
+    int read_int(const char* what) {
+        skip_blanks();
+        bool negative = p < end && *p == '-';
+        if (negative) {
+            ++p;
+        }
+        const char* digits = p;
+        uint64_t value = 0;
+        while (p < end && static_cast<unsigned>(*p - '0') < 10) {
+            value = value * 10 + (*p++ - '0');
+        }
+        if (p == digits) {
+            fail(string("expected ") + what);
+        }
+        if (p - digits > 10 || value > static_cast<uint64_t>(numeric_limits<int>::max())) {
+            fail(string(what) + " out of range");
+        }
+        return negative ? -static_cast<int>(value) : static_cast<int>(value);
+    }
+
+    int read_vertex_count() {
+        if (!next_line()) {
+            fail("missing vertex count");
+        }
+        int n = read_int("vertex count");
+        if (n < 0) {
+            fail("negative vertex count");
+        }
+        end_line();
+        return n;
+    }
+
+    template <typename EdgeFn>
+    void for_each_edge(int n, EdgeFn&& fn) {
+        while (next_line()) {
+            int src = read_int("source vertex");
+            int dst = read_int("destination vertex");
+            int weight = read_int("edge weight");
+            if (src < 0 || src >= n || dst < 0 || dst >= n) {
+                fail("vertex out of range [0, " + to_string(n) + ")");
+            }
+            end_line();
+            fn(src, dst, weight);
+        }
+    }
+};
+
+Graph::Graph(int n, size_t edges) : numVertices(n), storage(make_unique<Storage>(n * sizeof(EdgeList) + edges * sizeof(Edge))) {
+    storage->lists.resize(n);
+}
+
+Graph::Graph(const Graph& other) : Graph(other.numVertices, other.numEdges()) {
+    for (int u = 0; u < numVertices; ++u) {
+        storage->lists[u].assign(other[u].begin(), other[u].end());
+    }
+}
+
+Graph& Graph::operator=(const Graph& other) {
+    if (this != &other) {
+        *this = Graph(other);
+    }
+    return *this;
+}
+
+void Graph::resize(int n) {
+    if (!storage) {
+        storage = make_unique<Storage>(n * sizeof(EdgeList));
+    }
+    numVertices = n;
+    storage->lists.resize(n);
+}
+
+long long Graph::numEdges() const {
+    long long edges = 0;
+    for (int u = 0; u < numVertices; ++u) {
+        edges += storage->lists[u].size();
+    }
+    return edges;
+}
+
+// The counting pass sizes the arena for the whole graph, so it is filled
+// from a single block.
+void parse_graph_text(const char* text, size_t size, const string& filename, Graph& G) {
+    GraphTextScanner counter{text, text + size, filename};
+    int n = counter.read_vertex_count();
+    vector<int> degree(n, 0);
+    size_t edges = 0;
+    counter.for_each_edge(n, [&](int src, int, int) {
+        ++degree[src];
+        ++edges;
+    });
+
+    G = Graph(n, edges);
+    for (int u = 0; u < n; ++u) {
+        G[u].reserve(degree[u]);
+    }
+
+    GraphTextScanner filler{text, text + size, filename};
+    filler.read_vertex_count();
+    filler.for_each_edge(n, [&](int src, int dst, int weight) {
+        G.add_edge(src, dst, weight);
+    });
+}
+
+void parse_graph_text(const char* text, size_t size, const string& filename, CsrGraph& G) {
+    GraphTextScanner counter{text, text + size, filename};
+    int n = counter.read_vertex_count();
+    G.numVertices = n;
+    G.offsets.assign(n + 1, 0);
+    counter.for_each_edge(n, [&](int src, int, int) {
+        ++G.offsets[src + 1];
+    });
+    for (int u = 0; u < n; ++u) {
+        G.offsets[u + 1] += G.offsets[u];
+    }
+
+    G.dsts.resize(G.offsets[n]);
+    G.weights.resize(G.offsets[n]);
+    vector<int> next(G.offsets.begin(), G.offsets.end() - 1);
+
+    GraphTextScanner filler{text, text + size, filename};
+    filler.read_vertex_count();
+    filler.for_each_edge(n, [&](int src, int dst, int weight) {
+        int slot = next[src]++;
+        G.dsts[slot] = dst;
+        G.weights[slot] = weight;
+    });
+}
+
+void save_graph_binary(const CsrGraph& G, const string& filename) {
+    ofstream out(filename, ios::binary | ios::trunc);
+    if (!out) {
+        throw runtime_error("Cannot create binary graph file: " + filename);
+    }
+
+    GraphBinaryHeader header = {};
+    memcpy(header.magic, GRAPH_BINARY_MAGIC, sizeof(header.magic));
+    header.version = GRAPH_BINARY_VERSION;
+    header.numVertices = G.numVertices;
+    header.numEdges = G.numEdges();
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(G.offsets.data()), G.offsets.size() * sizeof(int));
+    out.write(reinterpret_cast<const char*>(G.dsts.data()), G.dsts.size() * sizeof(int));
+    out.write(reinterpret_cast<const char*>(G.weights.data()), G.weights.size() * sizeof(int));
+    if (!out) {
+        throw runtime_error("Cannot write binary graph file: " + filename);
+    }
+}
+
+bool is_graph_binary(const string& filename) {
+    ifstream in(filename, ios::binary);
+    char magic[sizeof(GRAPH_BINARY_MAGIC)];
+    return in.read(magic, sizeof(magic)) && memcmp(magic, GRAPH_BINARY_MAGIC, sizeof(magic)) == 0;
+}
+
+// A search follows edges from vertex to vertex across the whole file, so
+// readahead would mostly fetch pages it does not need next.
+MappedGraph::MappedGraph(const string& filename) : numVertices(0), file(filename, "graph file", MappedAccess::Random) {
+    GraphBinaryHeader header;
+    if (file.size() < sizeof(header)) {
+        throw runtime_error(filename + ": truncated binary graph header");
+    }
+    memcpy(&header, file.data(), sizeof(header));
+    if (memcmp(header.magic, GRAPH_BINARY_MAGIC, sizeof(header.magic)) != 0) {
+        throw runtime_error(filename + ": not a binary graph file");
+    }
+    if (header.version != GRAPH_BINARY_VERSION) {
+        throw runtime_error(filename + ": unsupported binary graph version " + to_string(header.version));
+    }
+    if (header.numVertices >= static_cast<uint64_t>(numeric_limits<int>::max())
+        || header.numEdges > static_cast<uint64_t>(numeric_limits<int>::max())) {
+        throw runtime_error(filename + ": graph too large");
+    }
+
+    uint64_t expected = sizeof(header) + (header.numVertices + 1 + 2 * header.numEdges) * sizeof(int);
+    if (file.size() != expected) {
+        throw runtime_error(filename + ": binary graph size does not match its header");
+    }
+
+    numVertices = header.numVertices;
+    offsets = reinterpret_cast<const int*>(file.data() + sizeof(header));
+    dsts = offsets + numVertices + 1;
+    weights = dsts + header.numEdges;
+
+    // Structural checks only, so a corrupt file cannot send a search out of
+    // bounds; no per-edge decoding happens.
+    if (offsets[0] != 0 || offsets[numVertices] != static_cast<int>(header.numEdges)) {
+        throw runtime_error(filename + ": corrupt offsets block");
+    }
+    for (int u = 0; u < numVertices; ++u) {
+        if (offsets[u] > offsets[u + 1]) {
+            throw runtime_error(filename + ": corrupt offsets block");
+        }
+    }
+    for (uint64_t i = 0; i < header.numEdges; ++i) {
+        if (static_cast<unsigned>(dsts[i]) >= static_cast<unsigned>(numVertices)) {
+            throw runtime_error(filename + ": edge destination out of range");
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#ifndef GRAPH_IO_H
+#define GRAPH_IO_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+// How a mapping will be read, passed on to the kernel as madvise advice:
+// Sequential for one front-to-back pass (aggressive readahead), Random for
+// lookups that jump around the file (no readahead), Normal for neither.
+enum class MappedAccess {
+    Sequential,
+    Random,
+    Normal
+};
+
+// Read-only memory mapping of a whole file. An empty file maps to an empty
+// range. kind names the file in error messages ("Cannot open <kind>: ...").
+class MappedFile {
+public:
+    explicit MappedFile(const string& filename, const string& kind = "file", MappedAccess access = MappedAccess::Sequential);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    const char* data() const {
+        return begin;
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+private:
+    const char* begin = nullptr;
+    size_t length = 0;
+};
+
+// Large reusable write buffer over a file descriptor, for output that is
+// produced a few bytes at a time. Integers are formatted with to_chars and
+// the descriptor only sees capacity-sized write() calls.
+class OutputBuffer {
+public:
+    explicit OutputBuffer(int fd, size_t capacity = 1 << 20);
+    // Creates or truncates filename.
+    explicit OutputBuffer(const string& filename, size_t capacity = 1 << 20);
+    ~OutputBuffer();
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    void put(char c) {
+        if (used == buffer.size()) {
+            flush();
+        }
+        buffer[used++] = c;
+    }
+
+    void write(string_view text);
+    void write_int(long long value);
+
+    // Returns size bytes at the end of the buffer, already counted as
+    // written; the caller fills them in any order. Grows the buffer when
+    // size exceeds its capacity.
+    char* claim(size_t size);
+
+    void flush();
+
+private:
+    int fd;
+    bool owns_fd = false;
+    vector<char> buffer;
+    size_t used = 0;
+};
+
+struct Graph;
+struct CsrGraph;
+
+// Parses the "n" header followed by one "src dst weight" line per edge. The
+// text is scanned twice, first counting out-degrees and then filling storage
+// sized from those counts, so no adjacency array is ever reallocated.
+// Malformed lines and out-of-range vertices are reported as
+// "<filename>:<line>: <problem>" in a runtime_error.
+void parse_graph_text(const char* text, size_t size, const string& filename, Graph& G);
+void parse_graph_text(const char* text, size_t size, const string& filename, CsrGraph& G);
+
+// Binary graph file, little-endian, every block 4-byte aligned:
+//   header   magic "HW9GRAPH", uint32 version, uint32 reserved,
+//            uint64 vertex count n, uint64 edge count m
+//   offsets  int32[n + 1], CSR row starts
+//   dsts     int32[m]
+//   weights  int32[m]
+// MappedGraph maps such a file and uses the blocks in place.
+const char GRAPH_BINARY_MAGIC[8] = {'H', 'W', '9', 'G', 'R', 'A', 'P', 'H'};
+const uint32_t GRAPH_BINARY_VERSION = 1;
+
+struct GraphBinaryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t numVertices;
+    uint64_t numEdges;
+};
+
+void save_graph_binary(const CsrGraph& G, const string& filename);
+bool is_graph_binary(const string& filename);
+
+#endif // GRAPH_IO_H
@@ -1,10 +1,206 @@
 #include "ladder.h"
 
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 void error(string word1, string word2, string msg) {
     cerr << "Error for words '" << word1 << "' and '" << word2 << "': " << msg << endl;
 }
 
-bool edit_distance_within(const string& str1, const string& str2, int d) {
+// Byte-wise comparison kernels. mismatch_block compares one full block and
+// returns a bit per differing byte; AVX2 and SSE2 do it in a load, compare
+// and movemask, the scalar fallback one byte at a time.
+#if defined(__AVX2__)
+static const size_t BLOCK_WIDTH = 32;
+
+static uint64_t mismatch_block(const char* a, const char* b) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+    return ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y))) & 0xffffffffu;
+}
+#elif defined(__SSE2__)
+static const size_t BLOCK_WIDTH = 16;
+
+static uint64_t mismatch_block(const char* a, const char* b) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+    __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+    return ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y))) & 0xffffu;
+}
+#else
+static const size_t BLOCK_WIDTH = 8;
+
+static uint64_t mismatch_block(const char* a, const char* b) {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < BLOCK_WIDTH; ++i) {
+        bits |= uint64_t(a[i] != b[i]) << i;
+    }
+    return bits;
+}
+#endif
+
+// Mismatch bits for the first n <= BLOCK_WIDTH bytes, never reading past n.
+static uint64_t mismatch_bits(const char* a, const char* b, size_t n) {
+    if (n == BLOCK_WIDTH) {
+        return mismatch_block(a, b);
+    }
+    char x[BLOCK_WIDTH] = {};
+    char y[BLOCK_WIDTH] = {};
+    memcpy(x, a, n);
+    memcpy(y, b, n);
+    return mismatch_block(x, y);
+}
+
+// Number of differing bytes, or some count above limit once it is exceeded.
+static int count_mismatches(const char* a, const char* b, size_t n, int limit) {
+    int diffs = 0;
+    for (size_t i = 0; i < n && diffs <= limit; i += BLOCK_WIDTH) {
+        diffs += popcount(mismatch_bits(a + i, b + i, min(BLOCK_WIDTH, n - i)));
+    }
+    return diffs;
+}
+
+// Index of the first differing byte, or n when the ranges are equal.
+static size_t first_mismatch(const char* a, const char* b, size_t n) {
+    for (size_t i = 0; i < n; i += BLOCK_WIDTH) {
+        uint64_t bits = mismatch_bits(a + i, b + i, min(BLOCK_WIDTH, n - i));
+        if (bits != 0) {
+            return i + countr_zero(bits);
+        }
+    }
+    return n;
+}
+
+// One 64-row block of Myers' bit-vector column step, in Hyyrö's block form.
+// pv and mv mark rows whose vertical delta is +1 and -1, eq the rows whose
+// pattern character matches the text character, and hin is the horizontal
+// delta entering the block's top row. Returns the horizontal delta leaving
+// the row selected by last. Branch-free apart from hin, which is the
+// constant 1 for the first block.
+static inline int advance_block(uint64_t& pv, uint64_t& mv, uint64_t eq, int hin, uint64_t last) {
+    uint64_t xv = eq | mv;
+    eq |= uint64_t(hin < 0);
+    uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+    uint64_t ph = mv | ~(xh | pv);
+    uint64_t mh = pv & xh;
+    int hout = int((ph & last) != 0) - int((mh & last) != 0);
+    ph = (ph << 1) | uint64_t(hin > 0);
+    mh = (mh << 1) | uint64_t(hin < 0);
+    pv = mh | ~(xv | ph);
+    mv = ph & xv;
+    return hout;
+}
+
+// Global edit distance between an m-character pattern, whose match masks
+// peq[c * blocks + b] cover 64 rows per block, and text. Gives up with
+// limit + 1 as soon as the last row cannot fall back to limit, since it
+// drops by at most one per remaining column.
+static int myers_distance(const uint64_t* peq, int m, string_view text, int limit) {
+    const int n = text.length();
+    const int blocks = (m + 63) / 64;
+    const uint64_t last = uint64_t(1) << ((m - 1) % 64);
+    int score = m;
+    
+    if (blocks == 1) {
+        uint64_t pv = ~uint64_t(0);
+        uint64_t mv = 0;
+        for (int j = 0; j < n; ++j) {
+            score += advance_block(pv, mv, peq[static_cast<unsigned char>(text[j])], 1, last);
+            if (score - (n - j - 1) > limit) {
+                return limit + 1;
+            }
+        }
+        return min(score, limit + 1);
+    }
+    
+    const uint64_t high = uint64_t(1) << 63;
+    vector<uint64_t> pv(blocks, ~uint64_t(0));
+    vector<uint64_t> mv(blocks, 0);
+    for (int j = 0; j < n; ++j) {
+        const uint64_t* eq = peq + static_cast<unsigned char>(text[j]) * blocks;
+        int carry = 1;
+        for (int b = 0; b < blocks; ++b) {
+            carry = advance_block(pv[b], mv[b], eq[b], carry, b + 1 == blocks ? last : high);
+        }
+        score += carry;
+        if (score - (n - j - 1) > limit) {
+            return limit + 1;
+        }
+    }
+    return min(score, limit + 1);
+}
+
+// Match masks for pattern into peq (256 * blocks words). Only the rows of
+// characters in pattern or text are written, which is all the kernel reads,
+// so a one-off distance does not pay for clearing the whole table.
+static void fill_match_masks(string_view pattern, string_view text, uint64_t* peq) {
+    const int blocks = (pattern.length() + 63) / 64;
+    for (string_view s : {pattern, text}) {
+        for (unsigned char c : s) {
+            fill(peq + c * blocks, peq + (c + 1) * blocks, 0);
+        }
+    }
+    for (size_t i = 0; i < pattern.length(); ++i) {
+        peq[static_cast<unsigned char>(pattern[i]) * blocks + i / 64] |= uint64_t(1) << (i % 64);
+    }
+}
+
+int bounded_edit_distance(string_view str1, string_view str2, int limit) {
+    // Matching ends never change the distance, so only the middle is run
+    // through the bit-vector kernel.
+    size_t prefix = first_mismatch(str1.data(), str2.data(), min(str1.length(), str2.length()));
+    str1.remove_prefix(prefix);
+    str2.remove_prefix(prefix);
+    while (!str1.empty() && !str2.empty() && str1.back() == str2.back()) {
+        str1.remove_suffix(1);
+        str2.remove_suffix(1);
+    }
+    
+    string_view pattern = str1.length() <= str2.length() ? str1 : str2;
+    string_view text = str1.length() <= str2.length() ? str2 : str1;
+    if (static_cast<long long>(text.length() - pattern.length()) > limit) {
+        return limit + 1;
+    }
+    if (pattern.empty()) {
+        return text.length();
+    }
+    
+    if (pattern.length() <= 64) {
+        uint64_t peq[256];
+        fill_match_masks(pattern, text, peq);
+        return myers_distance(peq, pattern.length(), text, limit);
+    }
+    vector<uint64_t> peq(256 * ((pattern.length() + 63) / 64));
+    fill_match_masks(pattern, text, peq.data());
+    return myers_distance(peq.data(), pattern.length(), text, limit);
+}
+
+EditDistancePattern::EditDistancePattern(string_view word) : length(word.length()), peq(256 * ((word.length() + 63) / 64), 0) {
+    const int blocks = (length + 63) / 64;
+    for (int i = 0; i < length; ++i) {
+        peq[static_cast<unsigned char>(word[i]) * blocks + i / 64] |= uint64_t(1) << (i % 64);
+    }
+}
+
+int EditDistancePattern::distance(string_view text, int limit) const {
+    if (abs(static_cast<long long>(text.length()) - length) > limit) {
+        return limit + 1;
+    }
+    if (length == 0) {
+        return text.length();
+    }
+    return myers_distance(peq.data(), length, text, limit);
+}
+
+bool edit_distance_within(string_view str1, string_view str2, int d) {
     int len1 = str1.length();
     int len2 = str2.length();
     
@@ -12,102 +208,315 @@ bool edit_distance_within(const string& str1, const string& str2, int d) {
         return false;
     }
     
-    if (len1 == len2) {
-        int diffs = 0;
-        for (int i = 0; i < len1; i++) {
-            if (str1[i] != str2[i]) {
-                diffs++;
-                if (diffs > d) {
-                    return false;
-                }
-            }
-        }
+    // A Hamming distance within d bounds the edit distance; beyond one edit
+    // it may overcount, so larger d falls through to the full kernel.
+    if (len1 == len2 && count_mismatches(str1.data(), str2.data(), len1, d) <= d) {
         return true;
     }
+    if (d <= 1 && len1 == len2) {
+        return false;
+    }
     
-    if (abs(len1 - len2) == 1) {
-        const string& shorter = (len1 < len2) ? str1 : str2;
-        const string& longer = (len1 < len2) ? str2 : str1;
+    if (d == 1) {
+        string_view shorter = (len1 < len2) ? str1 : str2;
+        string_view longer = (len1 < len2) ? str2 : str1;
         
-        int i = 0, j = 0;
-        bool skip_done = false;
-        
-        while (i < shorter.length() && j < longer.length()) {
-            if (shorter[i] != longer[j]) {
-                if (skip_done) {
-                    return false;
-                }
-                skip_done = true;
-                j++;
-            } else {
-                i++;
-                j++;
+        // One letter of the longer word may be skipped: the prefixes agree up
+        // to the first mismatch and the rest agrees shifted by one.
+        size_t skip = first_mismatch(shorter.data(), longer.data(), shorter.length());
+        return count_mismatches(shorter.data() + skip, longer.data() + skip + 1, shorter.length() - skip, 0) == 0;
+    }
+    
+    return bounded_edit_distance(str1, str2, d) <= d;
+}
+
+void edit_distance_within_batch(string_view word, const char* candidates, int count, int length, int d, vector<int>& matches) {
+    if (d > 1) {
+        // Beyond one edit a mismatch count no longer decides; build the
+        // query's match masks once and run the full kernel per candidate.
+        EditDistancePattern pattern(word);
+        for (int k = 0; k < count; ++k) {
+            if (pattern.distance(string_view(candidates + size_t(k) * length, length), d) <= d) {
+                matches.push_back(k);
             }
         }
-        
-        return true;
+        return;
     }
     
-    return false;
+    if (word.length() != static_cast<size_t>(length) || static_cast<size_t>(length) > BLOCK_WIDTH) {
+        for (int k = 0; k < count; ++k) {
+            if (edit_distance_within(word, string_view(candidates + size_t(k) * length, length), d)) {
+                matches.push_back(k);
+            }
+        }
+        return;
+    }
+    
+    // Same length and within one block: keep the padded query in a register
+    // and compare each candidate with a single block load. Bytes past the
+    // candidate belong to its successor and are masked off; only loads that
+    // would run past the final candidate go through the bounded copy.
+    char query[BLOCK_WIDTH] = {};
+    copy(word.begin(), word.end(), query);
+    const uint64_t mask = (uint64_t(1) << length) - 1;
+    const size_t total = size_t(count) * length;
+    
+    for (int k = 0; k < count; ++k) {
+        size_t offset = size_t(k) * length;
+        uint64_t bits = offset + BLOCK_WIDTH <= total
+            ? mismatch_block(query, candidates + offset) & mask
+            : mismatch_bits(query, candidates + offset, length);
+        if (popcount(bits) <= d) {
+            matches.push_back(k);
+        }
+    }
 }
 
-bool is_adjacent(const string& word1, const string& word2) {
+bool is_adjacent(string_view word1, string_view word2) {
     return edit_distance_within(word1, word2, 1);
 }
 
+// The set<string> overloads keep the graph they last built, one per thread,
+// and reuse it while the set holds exactly the same words. Checking that
+// takes one hash lookup per word instead of rebuilding the neighbor index.
+static const WordGraph& cached_word_graph(const set<string>& word_list) {
+    thread_local WordGraph cached;
+    bool same = cached.size() == static_cast<int>(word_list.size())
+        && all_of(word_list.begin(), word_list.end(), [&](const string& word) {
+            return cached.find(word) != -1;
+        });
+    if (!same) {
+        cached = WordGraph(word_list);
+    }
+    return cached;
+}
+
 vector<string> generate_word_ladder(const string& begin_word, const string& end_word, const set<string>& word_list) {
-    string begin = begin_word;
-    string end = end_word;
-    transform(begin.begin(), begin.end(), begin.begin(), ::tolower);
-    transform(end.begin(), end.end(), end.begin(), ::tolower);
+    return generate_word_ladder(begin_word, end_word, cached_word_graph(word_list));
+}
+
+vector<string> generate_word_ladder(const string& begin_word, const string& end_word, const set<string>& word_list, SearchStats& stats) {
+    StatsRecorder<true> recorder(&stats);
+    auto clock = recorder.now();
+    const WordGraph& graph = cached_word_graph(word_list);
+    recorder.phase(&SearchStats::setup_ms, clock);
+    return generate_word_ladder(begin_word, end_word, graph, LadderMode::Forward, stats);
+}
+
+// Breadth-first search over word IDs with stamped visited marks and parent
+// links; the ladder is only materialized once the end word is reached. A
+// begin word outside the dictionary gets the extra ID graph.size().
+template <bool Recording>
+static void forward_word_ladder(const WordGraph& graph, LadderWorkspace& ws, StatsRecorder<Recording> stats) {
+    auto clock = stats.now();
+    const int n = graph.size();
     
-    if (begin == end) {
-        error(begin_word, end_word, "Start and end words are the same");
-        return {};
+    int begin_id = graph.find(ws.begin);
+    if (begin_id == -1) {
+        begin_id = n;
     }
-    
-    if (word_list.find(end) == word_list.end()) {
-        error(begin_word, end_word, "End word not in dictionary");
-        return {};
+    int end_id = graph.find(ws.end);
+    long long comparisons = 0;
+    ws.begin_neighbors.clear();
+    if (begin_id == n) {
+        ws.begin_neighbors = graph.neighbors_of(ws.begin, &comparisons);
     }
+    stats.compared(comparisons);
     
-    queue<vector<string>> ladder_queue;
-    ladder_queue.push({begin});
+    StampedMarks& visited = ws.forward;
+    visited.reset(n + 1);
+    visited.set(begin_id, -1);
     
-    set<string> visited;
-    visited.insert(begin);
+    vector<int>& id_queue = ws.forward_frontier;
+    id_queue.clear();
+    id_queue.push_back(begin_id);
+    stats.pushed(1);
+    stats.phase(&SearchStats::setup_ms, clock);
     
-    while (!ladder_queue.empty()) {
-        vector<string> ladder = ladder_queue.front();
-        ladder_queue.pop();
+    bool found = false;
+    for (size_t head = 0; head < id_queue.size() && !found; ++head) {
+        int u = id_queue[head];
+        span<const int> neighbors = u == n ? span<const int>(ws.begin_neighbors) : graph.neighbors(u);
+        stats.popped();
+        stats.settled();
         
-        string last_word = ladder.back();
-        
-        if (last_word == end) {
-            return ladder;
-        }
-        
-        for (const string& word : word_list) {
-            if (visited.find(word) != visited.end()) {
+        for (int v : neighbors) {
+            stats.relaxed();
+            if (visited.test(v)) {
                 continue;
             }
-            
-            if (is_adjacent(last_word, word)) {
-                visited.insert(word);
-                
-                vector<string> new_ladder = ladder;
-                new_ladder.push_back(word);
-                
-                if (word == end) {
-                    return new_ladder;
+            visited.set(v, u);
+            stats.updated();
+            if (v == end_id) {
+                found = true;
+                break;
+            }
+            id_queue.push_back(v);
+            stats.pushed(id_queue.size() - head - 1);
+        }
+    }
+    stats.phase(&SearchStats::search_ms, clock);
+    
+    if (!found) {
+        return;
+    }
+    
+    for (int at = end_id; at != -1; at = visited.parent[at]) {
+        ws.ladder.push_back(at);
+    }
+    reverse(ws.ladder.begin(), ws.ladder.end());
+    stats.phase(&SearchStats::path_ms, clock);
+}
+
+// Level-synchronous search from both ends, always expanding the smaller
+// frontier. Both visited sets are complete balls when a level finishes, so
+// the first word reached from both sides lies on a shortest ladder. A begin
+// word outside the dictionary gets the extra ID graph.size().
+template <bool Recording>
+static void bidirectional_word_ladder(const WordGraph& graph, LadderWorkspace& ws, StatsRecorder<Recording> stats) {
+    auto clock = stats.now();
+    const int n = graph.size();
+    
+    int begin_id = graph.find(ws.begin);
+    if (begin_id == -1) {
+        begin_id = n;
+    }
+    int end_id = graph.find(ws.end);
+    long long comparisons = 0;
+    ws.begin_neighbors.clear();
+    if (begin_id == n) {
+        ws.begin_neighbors = graph.neighbors_of(ws.begin, &comparisons);
+    }
+    stats.compared(comparisons);
+    
+    auto neighbors = [&](int id) {
+        return id == n ? span<const int>(ws.begin_neighbors) : graph.neighbors(id);
+    };
+    
+    ws.forward.reset(n + 1);
+    ws.backward.reset(n + 1);
+    ws.forward.set(begin_id, -1);
+    ws.backward.set(end_id, -1);
+    
+    vector<int>& forward_frontier = ws.forward_frontier;
+    vector<int>& backward_frontier = ws.backward_frontier;
+    vector<int>& next_frontier = ws.next_frontier;
+    forward_frontier.assign(1, begin_id);
+    backward_frontier.assign(1, end_id);
+    stats.pushed(1);
+    stats.pushed(2);
+    stats.phase(&SearchStats::setup_ms, clock);
+    
+    int meeting = -1;
+    while (meeting == -1 && !forward_frontier.empty() && !backward_frontier.empty()) {
+        bool expand_forward = forward_frontier.size() <= backward_frontier.size();
+        vector<int>& frontier = expand_forward ? forward_frontier : backward_frontier;
+        StampedMarks& visited = expand_forward ? ws.forward : ws.backward;
+        const StampedMarks& other_visited = expand_forward ? ws.backward : ws.forward;
+        
+        next_frontier.clear();
+        for (size_t i = 0; i < frontier.size() && meeting == -1; ++i) {
+            int u = frontier[i];
+            stats.popped();
+            stats.settled();
+            for (int v : neighbors(u)) {
+                stats.relaxed();
+                if (visited.test(v)) {
+                    continue;
                 }
-                
-                ladder_queue.push(new_ladder);
+                visited.set(v, u);
+                stats.updated();
+                if (other_visited.test(v)) {
+                    meeting = v;
+                    break;
+                }
+                next_frontier.push_back(v);
+                stats.pushed(forward_frontier.size() + backward_frontier.size() - i - 1 + next_frontier.size());
             }
         }
+        frontier.swap(next_frontier);
+    }
+    stats.phase(&SearchStats::search_ms, clock);
+    
+    if (meeting == -1) {
+        return;
+    }
+    
+    for (int at = meeting; at != -1; at = ws.forward.parent[at]) {
+        ws.ladder.push_back(at);
+    }
+    reverse(ws.ladder.begin(), ws.ladder.end());
+    for (int at = ws.backward.parent[meeting]; at != -1; at = ws.backward.parent[at]) {
+        ws.ladder.push_back(at);
+    }
+    stats.phase(&SearchStats::path_ms, clock);
+}
+
+template <bool Recording>
+static span<const int> word_ladder(const string& begin_word, const string& end_word, const WordGraph& graph, LadderWorkspace& ws, LadderMode mode, StatsRecorder<Recording> stats) {
+    ws.ladder.clear();
+    ws.problem = nullptr;
+    ws.begin.assign(begin_word);
+    ws.end.assign(end_word);
+    transform(ws.begin.begin(), ws.begin.end(), ws.begin.begin(), ::tolower);
+    transform(ws.end.begin(), ws.end.end(), ws.end.begin(), ::tolower);
+    
+    if (ws.begin == ws.end) {
+        ws.problem = "Start and end words are the same";
+        return ws.ladder;
+    }
+    
+    if (graph.find(ws.end) == -1) {
+        ws.problem = "End word not in dictionary";
+        return ws.ladder;
     }
     
-    return {};
+    if (mode == LadderMode::Bidirectional) {
+        bidirectional_word_ladder(graph, ws, stats);
+    } else {
+        forward_word_ladder(graph, ws, stats);
+    }
+    return ws.ladder;
+}
+
+vector<string> LadderWorkspace::words(const WordGraph& graph) const {
+    vector<string> result;
+    result.reserve(ladder.size());
+    for (int id : ladder) {
+        result.push_back(id == graph.size() ? begin : string(graph.word(id)));
+    }
+    return result;
+}
+
+// Single queries report a rejected pair straight away; batches collect the
+// problems and report them after the workers finish.
+template <bool Recording>
+static span<const int> reported_word_ladder(const string& begin_word, const string& end_word, const WordGraph& graph, LadderWorkspace& ws, LadderMode mode, StatsRecorder<Recording> stats) {
+    span<const int> ladder = word_ladder(begin_word, end_word, graph, ws, mode, stats);
+    if (ws.problem != nullptr) {
+        error(begin_word, end_word, ws.problem);
+    }
+    return ladder;
+}
+
+vector<string> generate_word_ladder(const string& begin_word, const string& end_word, const WordGraph& graph, LadderMode mode) {
+    LadderWorkspace workspace;
+    reported_word_ladder(begin_word, end_word, graph, workspace, mode, StatsRecorder<false>());
+    return workspace.words(graph);
+}
+
+vector<string> generate_word_ladder(const string& begin_word, const string& end_word, const WordGraph& graph, LadderMode mode, SearchStats& stats) {
+    LadderWorkspace workspace;
+    reported_word_ladder(begin_word, end_word, graph, workspace, mode, StatsRecorder<true>(&stats));
+    return workspace.words(graph);
+}
+
+span<const int> generate_word_ladder(const string& begin_word, const string& end_word, const WordGraph& graph, LadderWorkspace& workspace, LadderMode mode) {
+    return reported_word_ladder(begin_word, end_word, graph, workspace, mode, StatsRecorder<false>());
+}
+
+span<const int> generate_word_ladder(const string& begin_word, const string& end_word, const WordGraph& graph, LadderWorkspace& workspace, LadderMode mode, SearchStats& stats) {
+    return reported_word_ladder(begin_word, end_word, graph, workspace, mode, StatsRecorder<true>(&stats));
 }
 
 void load_words(set<string>& word_list, const string& file_name) {
@@ -123,30 +532,145 @@ void load_words(set<string>& word_list, const string& file_name) {
     }
 }
 
-void print_word_ladder(const vector<string>& ladder) {
+void load_words(Dictionary& dict, const string& file_name) {
+    ifstream file(file_name, ios::binary);
+    if (!file) {
+        throw runtime_error("Cannot open dictionary file: " + file_name);
+    }
+    
+    string text((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    transform(text.begin(), text.end(), text.begin(), ::tolower);
+    
+    vector<string_view> words;
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && isspace(static_cast<unsigned char>(text[i]))) {
+            ++i;
+        }
+        size_t start = i;
+        while (i < text.size() && !isspace(static_cast<unsigned char>(text[i]))) {
+            ++i;
+        }
+        if (i > start) {
+            words.emplace_back(text.data() + start, i - start);
+        }
+    }
+    
+    dict = Dictionary(std::move(words));
+}
+
+void load_words(WordGraph& graph, const string& file_name) {
+    Dictionary dict;
+    load_words(dict, file_name);
+    graph = WordGraph(std::move(dict));
+}
+
+// Answers a batch of queries on a pool of workers sharing the read-only
+// graph. Workers claim small chunks of query indices from an atomic counter
+// and write into their own result slots, so nothing is locked and the output
+// stays in input order. Each worker reuses one LadderWorkspace. Rejected
+// pairs are reported in input order after the join, so workers never share
+// cerr.
+template <bool Recording>
+static vector<vector<string>> word_ladders(const vector<pair<string, string>>& queries, const WordGraph& graph, int num_threads, LadderMode mode, SearchStats* stats) {
+    vector<vector<string>> ladders(queries.size());
+    vector<const char*> problems(queries.size(), nullptr);
+    if (num_threads <= 0) {
+        num_threads = max(1u, thread::hardware_concurrency());
+    }
+    num_threads = min<size_t>(num_threads, max<size_t>(1, queries.size()));
+    
+    // Each worker counts into its own slot; they are summed after the join.
+    vector<SearchStats> worker_stats(Recording ? num_threads : 0);
+    const size_t chunk = 8;
+    atomic<size_t> next(0);
+    auto worker = [&](int t) {
+        StatsRecorder<Recording> recorder(Recording ? &worker_stats[t] : nullptr);
+        LadderWorkspace workspace;
+        for (size_t first = next.fetch_add(chunk); first < queries.size(); first = next.fetch_add(chunk)) {
+            size_t last = min(first + chunk, queries.size());
+            for (size_t i = first; i < last; ++i) {
+                word_ladder(queries[i].first, queries[i].second, graph, workspace, mode, recorder);
+                ladders[i] = workspace.words(graph);
+                problems[i] = workspace.problem;
+            }
+        }
+    };
+    
+    vector<thread> pool;
+    for (int t = 1; t < num_threads; ++t) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for (thread& t : pool) {
+        t.join();
+    }
+    for (size_t i = 0; i < queries.size(); ++i) {
+        if (problems[i] != nullptr) {
+            error(queries[i].first, queries[i].second, problems[i]);
+        }
+    }
+    for (const SearchStats& counted : worker_stats) {
+        *stats += counted;
+    }
+    return ladders;
+}
+
+vector<vector<string>> generate_word_ladders(const vector<pair<string, string>>& queries, const WordGraph& graph, int num_threads, LadderMode mode) {
+    return word_ladders<false>(queries, graph, num_threads, mode, nullptr);
+}
+
+vector<vector<string>> generate_word_ladders(const vector<pair<string, string>>& queries, const WordGraph& graph, SearchStats& stats, int num_threads, LadderMode mode) {
+    return word_ladders<true>(queries, graph, num_threads, mode, &stats);
+}
+
+vector<pair<string, string>> read_word_pairs(istream& in, const string& source) {
+    vector<pair<string, string>> pairs;
+    string line, word, begin;
+    int line_number = 0, begin_line = 0;
+    while (getline(in, line)) {
+        ++line_number;
+        istringstream words(line);
+        while (words >> word) {
+            if (begin.empty()) {
+                begin = word;
+                begin_line = line_number;
+            } else {
+                pairs.emplace_back(begin, word);
+                begin.clear();
+            }
+        }
+    }
+    if (!begin.empty()) {
+        throw runtime_error(source + ":" + to_string(begin_line) + ": word '" + begin + "' has no partner");
+    }
+    return pairs;
+}
+
+void print_word_ladder(const vector<string>& ladder, ostream& out) {
     if (ladder.empty()) {
-        cout << "No word ladder found." << endl;
+        out << "No word ladder found.\n";
         return;
     }
     
-    cout << "Word ladder found: ";
+    out << "Word ladder found: ";
     for (size_t i = 0; i < ladder.size(); ++i) {
-        cout << ladder[i];
-        cout << " ";
+        out << ladder[i];
+        out << " ";
     }
-    cout << endl;
+    out << "\n";
 }
 
 void verify_word_ladder() {
-    set<string> word_list;
-    load_words(word_list, "words.txt");
+    WordGraph graph;
+    load_words(graph, "words.txt");
     
     cout << "Testing word ladder generation..." << endl;
     
-    my_assert(generate_word_ladder("cat", "dog", word_list).size() == 4);
-    my_assert(generate_word_ladder("marty", "curls", word_list).size() == 6);
-    my_assert(generate_word_ladder("code", "data", word_list).size() == 6);
-    my_assert(generate_word_ladder("work", "play", word_list).size() == 6);
-    my_assert(generate_word_ladder("sleep", "awake", word_list).size() == 8);
-    my_assert(generate_word_ladder("car", "cheat", word_list).size() == 4);
+    my_assert(generate_word_ladder("cat", "dog", graph, LadderMode::Bidirectional).size() == 4);
+    my_assert(generate_word_ladder("marty", "curls", graph, LadderMode::Bidirectional).size() == 6);
+    my_assert(generate_word_ladder("code", "data", graph, LadderMode::Bidirectional).size() == 6);
+    my_assert(generate_word_ladder("work", "play", graph, LadderMode::Bidirectional).size() == 6);
+    my_assert(generate_word_ladder("sleep", "awake", graph, LadderMode::Bidirectional).size() == 8);
+    my_assert(generate_word_ladder("car", "cheat", graph, LadderMode::Bidirectional).size() == 4);
 }
\ No newline at end of file
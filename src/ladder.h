@@ -4,21 +4,86 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <queue>
 #include <set>
 #include <fstream>
 #include <algorithm>
+#include <utility>
+
+#include "word_graph.h"
+#include "search_stats.h"
 
 using namespace std;
 
+enum class LadderMode {
+    Forward,
+    Bidirectional
+};
+
+// Search state generate_word_ladder would otherwise allocate per query,
+// kept across calls on one thread. After warm-up a query between dictionary
+// words allocates nothing; a begin word outside the dictionary still builds
+// its neighbor list. ladder holds the last result as word IDs, graph.size()
+// standing for such a begin word, and is empty when there was none.
+struct LadderWorkspace {
+    StampedMarks forward;
+    StampedMarks backward;
+    vector<int> forward_frontier;
+    vector<int> backward_frontier;
+    vector<int> next_frontier;
+    vector<int> begin_neighbors;
+    string begin;
+    string end;
+    vector<int> ladder;
+    // Why the last pair was rejected before searching, or nullptr.
+    const char* problem = nullptr;
+
+    // The last ladder as words (allocates).
+    vector<string> words(const WordGraph& graph) const;
+};
+
 #define my_assert(e) {cout << #e << ((e) ? " passed": " failed") << endl;}
 
 void error(string word1, string word2, string msg);
-bool edit_distance_within(const string& str1, const string& str2, int d);
-bool is_adjacent(const string& word1, const string& word2);
+// Levenshtein distance, or limit + 1 once it is known to exceed limit
+// (0 <= limit < INT_MAX). Bit-parallel, 64 characters of the shorter string
+// per machine word.
+int bounded_edit_distance(string_view str1, string_view str2, int limit);
+// One word's bit-vector match masks, built once so that distances from it to
+// many other words each cost a single pass over the other word.
+class EditDistancePattern {
+public:
+    explicit EditDistancePattern(string_view word);
+    // Same contract as bounded_edit_distance(word, text, limit).
+    int distance(string_view text, int limit) const;
+
+private:
+    int length;
+    vector<uint64_t> peq;
+};
+bool edit_distance_within(string_view str1, string_view str2, int d);
+bool is_adjacent(string_view word1, string_view word2);
+// Appends to matches the index k of every candidate within distance d of
+// word, where candidate k is the length-byte string at candidates + k * length.
+void edit_distance_within_batch(string_view word, const char* candidates, int count, int length, int d, vector<int>& matches);
 vector<string> generate_word_ladder(const string& begin_word, const string& end_word, const set<string>& word_list);
+vector<string> generate_word_ladder(const string& begin_word, const string& end_word, const WordGraph& graph, LadderMode mode = LadderMode::Forward);
+// Same searches, also accumulating counters and phase timings into stats.
+vector<string> generate_word_ladder(const string& begin_word, const string& end_word, const set<string>& word_list, SearchStats& stats);
+vector<string> generate_word_ladder(const string& begin_word, const string& end_word, const WordGraph& graph, LadderMode mode, SearchStats& stats);
+// Same search through a reusable workspace; returns workspace.ladder.
+span<const int> generate_word_ladder(const string& begin_word, const string& end_word, const WordGraph& graph, LadderWorkspace& workspace, LadderMode mode = LadderMode::Forward);
+span<const int> generate_word_ladder(const string& begin_word, const string& end_word, const WordGraph& graph, LadderWorkspace& workspace, LadderMode mode, SearchStats& stats);
 void load_words(set<string>& word_list, const string& file_name);
-void print_word_ladder(const vector<string>& ladder);
+void load_words(Dictionary& dict, const string& file_name);
+void load_words(WordGraph& graph, const string& file_name);
+vector<vector<string>> generate_word_ladders(const vector<pair<string, string>>& queries, const WordGraph& graph, int num_threads = 0, LadderMode mode = LadderMode::Bidirectional);
+vector<vector<string>> generate_word_ladders(const vector<pair<string, string>>& queries, const WordGraph& graph, SearchStats& stats, int num_threads = 0, LadderMode mode = LadderMode::Bidirectional);
+// Reads whitespace-separated "begin end" pairs. A word left without a
+// partner throws runtime_error as "<source>:<line>: ...".
+vector<pair<string, string>> read_word_pairs(istream& in, const string& source = "input");
+void print_word_ladder(const vector<string>& ladder, ostream& out = cout);
 void verify_word_ladder();
 
 #endif // LADDER_H
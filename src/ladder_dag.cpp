@@ -0,0 +1,193 @@
+#include "ladder_dag.h"
+#include "ladder.h"
+
+#include <limits>
+
+string_view WordLadderDag::word(int node) const {
+    int id = ids[node];
+    return id == graph->size() ? string_view(begin_word) : graph->word(id);
+}
+
+uint64_t WordLadderDag::count() const {
+    if (empty()) {
+        return 0;
+    }
+    // Ladders from each node to the end word, filled back to front.
+    vector<uint64_t> ways(ids.size(), 0);
+    ways.back() = 1;
+    for (int node = static_cast<int>(ids.size()) - 2; node >= 0; --node) {
+        for (int next : successors_of(node)) {
+            ways[node] = ways[node] > numeric_limits<uint64_t>::max() - ways[next]
+                ? numeric_limits<uint64_t>::max()
+                : ways[node] + ways[next];
+        }
+    }
+    return ways.front();
+}
+
+// The iterator is an odometer over successor choices: choice[k] picks which
+// successor of path[k] becomes path[k + 1]. Every DAG node reaches the end
+// word, so any choice completes a ladder.
+WordLadderDag::iterator WordLadderDag::begin() const {
+    iterator it;
+    if (empty()) {
+        return it;
+    }
+    it.dag = this;
+    it.done = false;
+    it.path.assign(length(), 0);
+    it.choice.assign(length() - 1, 0);
+    for (int k = 0; k + 1 < length(); ++k) {
+        it.path[k + 1] = successors_of(it.path[k])[0];
+    }
+    return it;
+}
+
+vector<string> WordLadderDag::iterator::operator*() const {
+    vector<string> ladder;
+    ladder.reserve(path.size());
+    for (int node : path) {
+        ladder.emplace_back(dag->word(node));
+    }
+    return ladder;
+}
+
+WordLadderDag::iterator& WordLadderDag::iterator::operator++() {
+    for (int k = static_cast<int>(choice.size()) - 1; k >= 0; --k) {
+        span<const int> next = dag->successors_of(path[k]);
+        if (choice[k] + 1 < static_cast<int>(next.size())) {
+            path[k + 1] = next[++choice[k]];
+            for (int j = k + 1; j < static_cast<int>(choice.size()); ++j) {
+                choice[j] = 0;
+                path[j + 1] = dag->successors_of(path[j])[0];
+            }
+            return *this;
+        }
+    }
+    done = true;
+    return *this;
+}
+
+WordLadderDag generate_all_word_ladders(const string& begin_word, const string& end_word, const WordGraph& graph) {
+    LadderWorkspace workspace;
+    return generate_all_word_ladders(begin_word, end_word, graph, workspace);
+}
+
+WordLadderDag generate_all_word_ladders(const string& begin_word, const string& end_word, const WordGraph& graph, LadderWorkspace& ws) {
+    string& begin = ws.begin;
+    string& end = ws.end;
+    begin = begin_word;
+    end = end_word;
+    transform(begin.begin(), begin.end(), begin.begin(), ::tolower);
+    transform(end.begin(), end.end(), end.begin(), ::tolower);
+
+    WordLadderDag dag;
+    if (begin == end) {
+        error(begin_word, end_word, "Start and end words are the same");
+        return dag;
+    }
+    const int end_id = graph.find(end);
+    if (end_id == -1) {
+        error(begin_word, end_word, "End word not in dictionary");
+        return dag;
+    }
+
+    const int n = graph.size();
+    int begin_id = graph.find(begin);
+    if (begin_id == -1) {
+        begin_id = n;
+    }
+    ws.begin_neighbors.clear();
+    if (begin_id == n) {
+        ws.begin_neighbors = graph.neighbors_of(begin);
+    }
+    auto neighbors = [&](int id) {
+        return id == n ? span<const int>(ws.begin_neighbors) : graph.neighbors(id);
+    };
+
+    // Layered BFS. order lists the discovered words, layer by layer, and
+    // the stamped marks map a discovered word ID to its position there, so
+    // nothing sized by the dictionary is allocated per query. Every edge
+    // from layer k into layer k + 1 is kept as a (child, parent) pair of
+    // positions.
+    StampedMarks& discovered = ws.forward;
+    discovered.reset(n + 1);
+    auto index = [&](int id) {
+        return discovered.test(id) ? discovered.parent[id] : -1;
+    };
+    vector<int>& order = ws.forward_frontier;
+    order.assign(1, begin_id);
+    vector<int> layer_offsets = {0, 1};
+    vector<pair<int, int>> parents;
+    discovered.set(begin_id, 0);
+
+    bool reached = false;
+    while (!reached && layer_offsets.back() > layer_offsets[layer_offsets.size() - 2]) {
+        int first = layer_offsets[layer_offsets.size() - 2];
+        int last = layer_offsets.back();
+        for (int at = first; at < last; ++at) {
+            for (int v : neighbors(order[at])) {
+                if (!discovered.test(v)) {
+                    discovered.set(v, order.size());
+                    order.push_back(v);
+                }
+                if (index(v) >= last) {
+                    parents.push_back({index(v), at});
+                }
+            }
+        }
+        reached = discovered.test(end_id);
+        layer_offsets.push_back(order.size());
+    }
+    if (!reached) {
+        return dag;
+    }
+
+    // Keep the words that lead to the end word: walk back from it over the
+    // parent pairs, which sorted by child visit later layers first.
+    sort(parents.begin(), parents.end(), greater<pair<int, int>>());
+    vector<char> keep(order.size(), 0);
+    keep[index(end_id)] = 1;
+    for (const auto& [child, parent] : parents) {
+        if (keep[child]) {
+            keep[parent] = 1;
+        }
+    }
+
+    // Renumber the kept words in BFS order. The last layer may hold other
+    // words discovered alongside the end word; only the end word survives,
+    // so it is the last node.
+    vector<int> node(order.size(), -1);
+    dag.layer_offsets.push_back(0);
+    for (size_t k = 0; k + 1 < layer_offsets.size(); ++k) {
+        for (int at = layer_offsets[k]; at < layer_offsets[k + 1]; ++at) {
+            if (keep[at]) {
+                node[at] = dag.ids.size();
+                dag.ids.push_back(order[at]);
+            }
+        }
+        dag.layer_offsets.push_back(dag.ids.size());
+    }
+
+    // Successor lists in CSR form, ascending by node.
+    dag.successor_offsets.assign(dag.ids.size() + 1, 0);
+    for (const auto& [child, parent] : parents) {
+        if (keep[child]) {
+            ++dag.successor_offsets[node[parent] + 1];
+        }
+    }
+    for (size_t i = 0; i < dag.ids.size(); ++i) {
+        dag.successor_offsets[i + 1] += dag.successor_offsets[i];
+    }
+    dag.successors.resize(dag.successor_offsets.back());
+    vector<int> next(dag.successor_offsets.begin(), dag.successor_offsets.end() - 1);
+    for (auto it = parents.rbegin(); it != parents.rend(); ++it) {
+        if (keep[it->first]) {
+            dag.successors[next[node[it->second]]++] = node[it->first];
+        }
+    }
+
+    dag.graph = &graph;
+    dag.begin_word = begin;
+    return dag;
+}
@@ -0,0 +1,108 @@
+#ifndef LADDER_DAG_H
+#define LADDER_DAG_H
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "word_graph.h"
+
+using namespace std;
+
+struct LadderWorkspace;
+
+// Every shortest ladder between two words, kept as a layered DAG instead of
+// a list of paths. Node 0 is the begin word and the last node is the end
+// word; layer k holds the words k steps from the begin word that lie on at
+// least one shortest ladder, and each node links to its successors in the
+// next layer. Storage is one entry per DAG node and edge, however many
+// ladders the DAG encodes, and iterating produces the ladders one at a time.
+//
+// Words are referenced by WordGraph ID, so the graph must outlive the DAG.
+class WordLadderDag {
+public:
+    class iterator {
+    public:
+        // The current ladder, materialized on demand.
+        vector<string> operator*() const;
+        iterator& operator++();
+
+        bool operator!=(const iterator& other) const {
+            return done != other.done;
+        }
+
+        // DAG nodes of the current ladder, one per layer.
+        const vector<int>& nodes() const {
+            return path;
+        }
+
+    private:
+        friend class WordLadderDag;
+        const WordLadderDag* dag = nullptr;
+        vector<int> path;
+        vector<int> choice;
+        bool done = true;
+    };
+
+    WordLadderDag() = default;
+
+    bool empty() const {
+        return ids.empty();
+    }
+
+    // Words per ladder, 0 when there is none.
+    int length() const {
+        return layer_offsets.empty() ? 0 : static_cast<int>(layer_offsets.size()) - 1;
+    }
+
+    int node_count() const {
+        return ids.size();
+    }
+
+    int edge_count() const {
+        return successors.size();
+    }
+
+    // Nodes are numbered layer by layer: layer k is
+    // [layer_begin(k), layer_begin(k + 1)).
+    int layer_begin(int k) const {
+        return layer_offsets[k];
+    }
+
+    span<const int> successors_of(int node) const {
+        return span<const int>(successors.data() + successor_offsets[node], successor_offsets[node + 1] - successor_offsets[node]);
+    }
+
+    string_view word(int node) const;
+
+    // Number of ladders, saturating at UINT64_MAX.
+    uint64_t count() const;
+
+    iterator begin() const;
+    iterator end() const {
+        return iterator();
+    }
+
+private:
+    friend WordLadderDag generate_all_word_ladders(const string& begin_word, const string& end_word, const WordGraph& graph, LadderWorkspace& workspace);
+
+    const WordGraph* graph = nullptr;
+    string begin_word;
+    vector<int> ids;                // node -> word ID; graph.size() is begin_word
+    vector<int> layer_offsets;
+    vector<int> successor_offsets;
+    vector<int> successors;
+};
+
+// One layered BFS from begin_word that stops after the layer reaching
+// end_word, then keeps only the words from which end_word is still reached
+// on schedule. Returns an empty DAG (with the same error messages as
+// generate_word_ladder) when there is no ladder.
+WordLadderDag generate_all_word_ladders(const string& begin_word, const string& end_word, const WordGraph& graph);
+// Same search through a reusable workspace, whose search state it
+// overwrites; after warm-up only the DAG itself is sized per query.
+WordLadderDag generate_all_word_ladders(const string& begin_word, const string& end_word, const WordGraph& graph, LadderWorkspace& workspace);
+
+#endif // LADDER_DAG_H
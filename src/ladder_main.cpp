@@ -1,10 +1,110 @@
 #include "ladder.h"
+#include "ladder_dag.h"
 
-int main() {
+#include <sstream>
+#include <charconv>
+
+// Usage: ladder_main [--snapshot file] [--batch [pairs_file]] [--threads N] [--stats] [--all]
+//        ladder_main --build-snapshot words_file snapshot_file
+// The dictionary is words.txt unless --snapshot names a word graph written
+// by --build-snapshot, which loads without rebuilding any adjacency.
+// Batch mode answers every "begin end" pair in pairs_file (stdin when the
+// file is omitted or "-") and prints one result line per pair in input order.
+// --stats prints search counters to stderr, summed over the batch. --all
+// makes the interactive query print every shortest ladder.
+// The argument after argv[i], which option arg requires.
+static string option_value(int argc, char* argv[], int& i, const string& arg) {
+    if (i + 1 >= argc) {
+        throw runtime_error("Missing value for " + arg);
+    }
+    return argv[++i];
+}
+
+// A non-negative thread count; 0 means one per hardware thread.
+static int parse_thread_count(const string& text) {
+    int count = 0;
+    auto [end, ec] = from_chars(text.data(), text.data() + text.size(), count);
+    if (ec != errc() || end != text.data() + text.size() || count < 0) {
+        throw invalid_argument("Bad thread count: " + text);
+    }
+    return count;
+}
+
+static int run_batch(const WordGraph& graph, const string& pairs_file, int num_threads, bool show_stats) {
+    vector<pair<string, string>> queries;
+    if (pairs_file.empty() || pairs_file == "-") {
+        queries = read_word_pairs(cin, "stdin");
+    } else {
+        ifstream file(pairs_file);
+        if (!file) {
+            throw runtime_error("Cannot open word pair file: " + pairs_file);
+        }
+        queries = read_word_pairs(file, pairs_file);
+    }
+    
+    SearchStats stats;
+    vector<vector<string>> ladders = show_stats
+        ? generate_word_ladders(queries, graph, stats, num_threads)
+        : generate_word_ladders(queries, graph, num_threads);
+    
+    ostringstream out;
+    for (const vector<string>& ladder : ladders) {
+        print_word_ladder(ladder, out);
+    }
+    cout << out.str() << flush;
+    if (show_stats) {
+        print_search_stats(stats);
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
     try {
-        set<string> word_list;
-        load_words(word_list, "words.txt");
-        cout << "Loaded " << word_list.size() << " words from dictionary." << endl;
+        bool batch = false;
+        string pairs_file;
+        int num_threads = 0;
+        bool show_stats = false;
+        bool all_ladders = false;
+        string snapshot;
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            if (arg == "--batch") {
+                batch = true;
+                if (i + 1 < argc && string(argv[i + 1]).rfind("--", 0) != 0) {
+                    pairs_file = argv[++i];
+                }
+            } else if (arg == "--threads") {
+                num_threads = parse_thread_count(option_value(argc, argv, i, arg));
+            } else if (arg == "--stats") {
+                show_stats = true;
+            } else if (arg == "--all") {
+                all_ladders = true;
+            } else if (arg == "--snapshot") {
+                snapshot = option_value(argc, argv, i, arg);
+            } else if (arg == "--build-snapshot") {
+                string words_file = option_value(argc, argv, i, arg);
+                string snapshot_file = option_value(argc, argv, i, arg);
+                WordGraph graph;
+                load_words(graph, words_file);
+                save_word_graph(graph, snapshot_file);
+                return 0;
+            } else {
+                throw runtime_error("Unknown argument: " + arg);
+            }
+        }
+        
+        WordGraph graph;
+        if (snapshot.empty()) {
+            load_words(graph, "words.txt");
+        } else {
+            read_word_graph(graph, snapshot);
+        }
+        
+        if (batch) {
+            return run_batch(graph, pairs_file, num_threads, show_stats);
+        }
+        
+        cout << "Loaded " << graph.size() << " words from dictionary." << endl;
         
         char option;
         cout << "Run verification tests? (y/n): ";
@@ -21,8 +121,23 @@ int main() {
         cout << "Enter end word: ";
         cin >> end_word;
         
-        vector<string> ladder = generate_word_ladder(start_word, end_word, word_list);
+        if (all_ladders) {
+            WordLadderDag dag = generate_all_word_ladders(start_word, end_word, graph);
+            cout << dag.count() << " shortest ladders found.\n";
+            for (const vector<string>& ladder : dag) {
+                print_word_ladder(ladder);
+            }
+            return 0;
+        }
+        
+        SearchStats stats;
+        vector<string> ladder = show_stats
+            ? generate_word_ladder(start_word, end_word, graph, LadderMode::Bidirectional, stats)
+            : generate_word_ladder(start_word, end_word, graph, LadderMode::Bidirectional);
         print_word_ladder(ladder);
+        if (show_stats) {
+            print_search_stats(stats);
+        }
     }
     catch (const exception& e) {
         cerr << "Error: " << e.what() << endl;
@@ -0,0 +1,118 @@
+#ifndef SEARCH_STATS_H
+#define SEARCH_STATS_H
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+// Counters filled in by the dijkstra_shortest_path and generate_word_ladder
+// overloads that take a SearchStats&. Values accumulate across calls, so one
+// object can summarize a whole batch.
+struct SearchStats {
+    long long nodes_settled = 0;
+    long long edges_relaxed = 0;      // out-edges examined from settled nodes
+    long long distance_updates = 0;   // relaxations that improved a label
+    long long pushes = 0;
+    long long pops = 0;
+    long long stale_pops = 0;         // popped entries already settled
+    long long adjacency_checks = 0;   // edit-distance comparisons
+    long long peak_frontier = 0;
+    double setup_ms = 0;
+    double search_ms = 0;
+    double path_ms = 0;
+
+    SearchStats& operator+=(const SearchStats& other) {
+        nodes_settled += other.nodes_settled;
+        edges_relaxed += other.edges_relaxed;
+        distance_updates += other.distance_updates;
+        pushes += other.pushes;
+        pops += other.pops;
+        stale_pops += other.stale_pops;
+        adjacency_checks += other.adjacency_checks;
+        peak_frontier = max(peak_frontier, other.peak_frontier);
+        setup_ms += other.setup_ms;
+        search_ms += other.search_ms;
+        path_ms += other.path_ms;
+        return *this;
+    }
+};
+
+inline void print_search_stats(const SearchStats& stats, ostream& out = cerr) {
+    out << "nodes settled:     " << stats.nodes_settled << '\n'
+        << "edges relaxed:     " << stats.edges_relaxed << '\n'
+        << "distance updates:  " << stats.distance_updates << '\n'
+        << "pushes:            " << stats.pushes << '\n'
+        << "pops:              " << stats.pops << '\n'
+        << "stale pops:        " << stats.stale_pops << '\n'
+        << "adjacency checks:  " << stats.adjacency_checks << '\n'
+        << "peak frontier:     " << stats.peak_frontier << '\n'
+        << "setup ms:          " << stats.setup_ms << '\n'
+        << "search ms:         " << stats.search_ms << '\n'
+        << "path ms:           " << stats.path_ms << '\n';
+}
+
+// What the search loops actually call. StatsRecorder<false> has empty
+// members and never reads the clock, so the default overloads compile to
+// the same code as before the counters existed.
+template <bool Enabled>
+class StatsRecorder {
+public:
+    using Clock = chrono::steady_clock;
+
+    explicit StatsRecorder(SearchStats* stats = nullptr) : stats(stats) {}
+
+    void settled() {
+        if constexpr (Enabled) ++stats->nodes_settled;
+    }
+
+    void relaxed() {
+        if constexpr (Enabled) ++stats->edges_relaxed;
+    }
+
+    void updated() {
+        if constexpr (Enabled) ++stats->distance_updates;
+    }
+
+    void pushed(size_t frontier) {
+        if constexpr (Enabled) {
+            ++stats->pushes;
+            stats->peak_frontier = max<long long>(stats->peak_frontier, frontier);
+        }
+    }
+
+    void popped() {
+        if constexpr (Enabled) ++stats->pops;
+    }
+
+    void stale() {
+        if constexpr (Enabled) ++stats->stale_pops;
+    }
+
+    void compared(long long count) {
+        if constexpr (Enabled) stats->adjacency_checks += count;
+    }
+
+    Clock::time_point now() const {
+        if constexpr (Enabled) {
+            return Clock::now();
+        } else {
+            return {};
+        }
+    }
+
+    // Charges the time since start to one phase and restarts the clock.
+    void phase(double SearchStats::* field, Clock::time_point& start) {
+        if constexpr (Enabled) {
+            Clock::time_point end = Clock::now();
+            stats->*field += chrono::duration<double, milli>(end - start).count();
+            start = end;
+        }
+    }
+
+private:
+    [[maybe_unused]] SearchStats* stats;
+};
+
+#endif // SEARCH_STATS_H
@@ -0,0 +1,212 @@
+#include "shortest_path_tree.h"
+#include "dijkstra_engine.h"
+
+static void check_weight(int weight) {
+    if (weight <= 0) {
+        throw invalid_argument("ShortestPathTree requires positive edge weights");
+    }
+}
+
+ShortestPathTree::ShortestPathTree(const Graph& graph, int source)
+    : G(graph), in_edges(graph.numVertices), root(source), state(graph.numVertices, 0) {
+    for (int u = 0; u < G.numVertices; ++u) {
+        for (size_t i = 0; i < G[u].size(); ++i) {
+            check_weight(G[u][i].weight);
+            in_edges[G[u][i].dst].push_back({u, static_cast<int>(i)});
+        }
+    }
+    distance = dijkstra_shortest_path(G, root, parent);
+}
+
+void ShortestPathTree::insert_edge(int src, int dst, int weight) {
+    check_weight(weight);
+    if (src < 0 || src >= G.numVertices || dst < 0 || dst >= G.numVertices) {
+        throw out_of_range("Edge endpoint out of range");
+    }
+    G.add_edge(src, dst, weight);
+    in_edges[dst].push_back({src, static_cast<int>(G[src].size()) - 1});
+    decrease(src, dst, weight);
+}
+
+void ShortestPathTree::update_edge_weight(int src, int dst, int weight) {
+    check_weight(weight);
+    if (src < 0 || src >= G.numVertices) {
+        throw out_of_range("Edge endpoint out of range");
+    }
+    auto edge = find_if(G[src].begin(), G[src].end(), [&](const Edge& e) {
+        return e.dst == dst;
+    });
+    if (edge == G[src].end()) {
+        throw invalid_argument("No edge " + to_string(src) + " -> " + to_string(dst));
+    }
+
+    int old_weight = edge->weight;
+    edge->weight = weight;
+    touched = 0;
+    if (weight < old_weight) {
+        decrease(src, dst, weight);
+    } else if (weight > old_weight) {
+        increase(src, dst, old_weight);
+    }
+}
+
+// Whether u -> v (of this weight) lies on a shortest path. The sum
+// saturates at INF, so it never wraps into a finite distance.
+bool ShortestPathTree::tight(int u, int weight, int v) const {
+    return distance[v] != INF && saturating_add(distance[u], weight) == distance[v];
+}
+
+void ShortestPathTree::recompute_parent(int v) {
+    int best = -1;
+    if (v != root && distance[v] != INF) {
+        for (const auto& [u, index] : in_edges[v]) {
+            if (!tight(u, G[u][index].weight, v)) {
+                continue;
+            }
+            if (best == -1 || distance[u] < distance[best] || (distance[u] == distance[best] && u < best)) {
+                best = u;
+            }
+        }
+    }
+    parent[v] = best;
+}
+
+// The edge src -> dst got cheaper (or is new). Distances can only drop, and
+// only for vertices reached through dst, so a Dijkstra seeded at dst that
+// follows strict improvements visits exactly the changed region.
+void ShortestPathTree::decrease(int src, int dst, int weight) {
+    touched = 0;
+    int reached = saturating_add(distance[src], weight);
+    if (distance[src] == INF || reached > distance[dst]) {
+        return;
+    }
+    if (reached == distance[dst]) {
+        recompute_parent(dst);
+        touched = 1;
+        return;
+    }
+
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+    distance[dst] = reached;
+    pq.push({distance[dst], dst});
+
+    vector<int> changed;
+    while (!pq.empty()) {
+        auto [d, x] = pq.top();
+        pq.pop();
+        if (d != distance[x]) {
+            continue;
+        }
+        changed.push_back(x);
+        for (const Edge& edge : G[x]) {
+            int candidate = saturating_add(distance[x], edge.weight);
+            if (candidate < distance[edge.dst]) {
+                distance[edge.dst] = candidate;
+                pq.push({candidate, edge.dst});
+            }
+        }
+    }
+
+    vector<int> repair = changed;
+    for (int x : changed) {
+        for (const Edge& edge : G[x]) {
+            repair.push_back(edge.dst);
+        }
+    }
+    sort(repair.begin(), repair.end());
+    repair.erase(unique(repair.begin(), repair.end()), repair.end());
+    for (int v : repair) {
+        recompute_parent(v);
+    }
+    touched = repair.size();
+}
+
+// The edge src -> dst got dearer. If it was tight, find the vertices that
+// lost every tight path from the root: visiting candidates in distance
+// order, a vertex is affected when none of its tight in-edges comes from an
+// unaffected vertex, and only then are its tight successors candidates.
+// Affected vertices are re-seeded from unaffected in-neighbors and settled
+// by a Dijkstra confined to that set.
+void ShortestPathTree::increase(int src, int dst, int old_weight) {
+    touched = 0;
+    if (!tight(src, old_weight, dst)) {
+        return;
+    }
+
+    vector<int> candidates = {dst};
+    vector<int> affected;
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+    pq.push({distance[dst], dst});
+
+    const char candidate = 1, hit = 2;
+    state[dst] = candidate;
+
+    while (!pq.empty()) {
+        int x = pq.top().second;
+        pq.pop();
+
+        bool supported = false;
+        for (const auto& [u, index] : in_edges[x]) {
+            if (tight(u, G[u][index].weight, x) && state[u] != hit) {
+                supported = true;
+                break;
+            }
+        }
+        if (supported) {
+            continue;
+        }
+
+        affected.push_back(x);
+        state[x] = hit;
+        for (const Edge& edge : G[x]) {
+            if (tight(x, edge.weight, edge.dst) && state[edge.dst] == 0) {
+                state[edge.dst] = candidate;
+                candidates.push_back(edge.dst);
+                pq.push({distance[edge.dst], edge.dst});
+            }
+        }
+    }
+
+    for (int x : candidates) {
+        state[x] = 0;
+    }
+    for (int x : affected) {
+        distance[x] = INF;
+    }
+    for (int x : affected) {
+        for (const auto& [u, index] : in_edges[x]) {
+            distance[x] = min(distance[x], saturating_add(distance[u], G[u][index].weight));
+        }
+        if (distance[x] != INF) {
+            pq.push({distance[x], x});
+        }
+    }
+    while (!pq.empty()) {
+        auto [d, x] = pq.top();
+        pq.pop();
+        if (d != distance[x]) {
+            continue;
+        }
+        for (const Edge& edge : G[x]) {
+            int candidate = saturating_add(distance[x], edge.weight);
+            if (candidate < distance[edge.dst]) {
+                distance[edge.dst] = candidate;
+                pq.push({candidate, edge.dst});
+            }
+        }
+    }
+
+    vector<int> repair = affected;
+    repair.push_back(dst);
+    for (int x : affected) {
+        for (const Edge& edge : G[x]) {
+            repair.push_back(edge.dst);
+        }
+    }
+    sort(repair.begin(), repair.end());
+    repair.erase(unique(repair.begin(), repair.end()), repair.end());
+    for (int v : repair) {
+        recompute_parent(v);
+    }
+    touched = candidates.size() + repair.size();
+}
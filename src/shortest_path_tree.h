@@ -0,0 +1,62 @@
+#ifndef SHORTEST_PATH_TREE_H
+#define SHORTEST_PATH_TREE_H
+
+#include "dijkstras.h"
+
+// Cached single-source shortest-path tree over its own copy of a graph,
+// repaired incrementally as edges are inserted or reweighted. Only the
+// vertices whose distance changes (plus their direct successors, whose
+// parent choice may change) are revisited.
+//
+// The cached vectors stay identical to dijkstra_shortest_path on the
+// current graph. With strictly positive weights that engine settles
+// vertices in (distance, vertex) order, so previous[v] is always the tight
+// in-neighbor u (distance[u] + w(u, v) == distance[v]) with the smallest
+// (distance[u], u); the repair recomputes exactly that. Zero and negative
+// weights are rejected because they break this characterization.
+class ShortestPathTree {
+public:
+    ShortestPathTree(const Graph& G, int source);
+
+    const Graph& graph() const {
+        return G;
+    }
+
+    int source() const {
+        return root;
+    }
+
+    const vector<int>& distances() const {
+        return distance;
+    }
+
+    const vector<int>& previous() const {
+        return parent;
+    }
+
+    // Number of vertices revisited by the last update.
+    int last_update_size() const {
+        return touched;
+    }
+
+    void insert_edge(int src, int dst, int weight);
+
+    // Reweights the first src -> dst edge, in either direction.
+    void update_edge_weight(int src, int dst, int weight);
+
+private:
+    Graph G;
+    vector<vector<pair<int, int>>> in_edges;
+    int root;
+    vector<int> distance;
+    vector<int> parent;
+    vector<char> state;
+    int touched = 0;
+
+    void decrease(int src, int dst, int weight);
+    void increase(int src, int dst, int old_weight);
+    bool tight(int u, int weight, int v) const;
+    void recompute_parent(int v);
+};
+
+#endif // SHORTEST_PATH_TREE_H
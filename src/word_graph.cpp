@@ -0,0 +1,248 @@
+#include "word_graph.h"
+#include "ladder.h"
+#include "graph_io.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+WordGraph::WordGraph(const set<string>& word_list)
+    : WordGraph(Dictionary(vector<string_view>(word_list.begin(), word_list.end()))) {}
+
+WordGraph::WordGraph(Dictionary dictionary) : dict(std::move(dictionary)) {
+    vector<pair<int, int>> edges;
+
+    // Substitutions: within one length group, words sharing the pattern with
+    // position i wildcarded sort next to each other and are pairwise adjacent.
+    vector<int> group;
+    for (int len = 1; len <= dict.max_length(); ++len) {
+        group.resize(dict.last_of_length(len) - dict.first_of_length(len));
+        for (int i = 0; i < len; ++i) {
+            auto masked_compare = [&](int a, int b) {
+                string_view x = dict.word(a);
+                string_view y = dict.word(b);
+                int c = x.substr(0, i).compare(y.substr(0, i));
+                return c != 0 ? c : x.substr(i + 1).compare(y.substr(i + 1));
+            };
+
+            for (size_t k = 0; k < group.size(); ++k) {
+                group[k] = dict.first_of_length(len) + k;
+            }
+            sort(group.begin(), group.end(), [&](int a, int b) {
+                return masked_compare(a, b) < 0;
+            });
+
+            for (size_t run = 0; run < group.size();) {
+                size_t run_end = run + 1;
+                while (run_end < group.size() && masked_compare(group[run], group[run_end]) == 0) {
+                    ++run_end;
+                }
+                for (size_t a = run; a < run_end; ++a) {
+                    for (size_t b = run; b < run_end; ++b) {
+                        if (a != b) {
+                            edges.emplace_back(group[a], group[b]);
+                        }
+                    }
+                }
+                run = run_end;
+            }
+        }
+    }
+
+    // Insertions and deletions: a word is adjacent to every dictionary word
+    // obtained by deleting one of its letters.
+    string deleted;
+    for (int id = 0; id < size(); ++id) {
+        string_view w = dict.word(id);
+        for (size_t i = 0; i < w.length(); ++i) {
+            deleted.assign(w.substr(0, i));
+            deleted.append(w.substr(i + 1));
+            int shorter = dict.find(deleted);
+            if (shorter != -1) {
+                edges.emplace_back(id, shorter);
+                edges.emplace_back(shorter, id);
+            }
+        }
+    }
+
+    sort(edges.begin(), edges.end());
+    edges.erase(unique(edges.begin(), edges.end()), edges.end());
+
+    offsets.assign(size() + 1, 0);
+    for (const auto& [src, dst] : edges) {
+        ++offsets[src + 1];
+    }
+    for (int id = 0; id < size(); ++id) {
+        offsets[id + 1] += offsets[id];
+    }
+    adjacent.reserve(edges.size());
+    for (const auto& [src, dst] : edges) {
+        adjacent.push_back(dst);
+    }
+}
+
+vector<int> WordGraph::neighbors_of(string_view word, long long* comparisons) const {
+    vector<int> found;
+    int len = word.length();
+
+    string deleted;
+    for (int i = 0; i < len; ++i) {
+        deleted.assign(word.substr(0, i));
+        deleted.append(word.substr(i + 1));
+        int id = dict.find(deleted);
+        if (id != -1) {
+            found.push_back(id);
+        }
+    }
+
+    if (comparisons) {
+        *comparisons += len;
+    }
+
+    vector<int> matches;
+    for (int group = len; group <= len + 1; ++group) {
+        int first = dict.first_of_length(group);
+        int count = dict.last_of_length(group) - first;
+        matches.clear();
+        edit_distance_within_batch(word, dict.block_of_length(group), count, group, 1, matches);
+        if (comparisons) {
+            *comparisons += count;
+        }
+        for (int k : matches) {
+            if (dict.word(first + k) != word) {
+                found.push_back(first + k);
+            }
+        }
+    }
+
+    sort(found.begin(), found.end());
+    found.erase(unique(found.begin(), found.end()), found.end());
+    return found;
+}
+
+template <typename T>
+static void write_block(ofstream& out, const vector<T>& block) {
+    out.write(reinterpret_cast<const char*>(block.data()), block.size() * sizeof(T));
+}
+
+void save_word_graph(const WordGraph& graph, const string& filename) {
+    ofstream out(filename, ios::binary | ios::trunc);
+    if (!out) {
+        throw runtime_error("Cannot create word graph file: " + filename);
+    }
+
+    const Dictionary& dict = graph.dict;
+    WordGraphHeader header = {};
+    memcpy(header.magic, WORD_GRAPH_MAGIC, sizeof(header.magic));
+    header.version = WORD_GRAPH_VERSION;
+    header.words = dict.size();
+    header.arenaBytes = dict.arena.size();
+    header.lengthGroups = dict.length_begin.size();
+    header.tableSlots = dict.table.size();
+    header.edges = graph.adjacent.size();
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write_block(out, dict.offsets);
+    write_block(out, dict.length_begin);
+    write_block(out, dict.table);
+    write_block(out, graph.offsets);
+    write_block(out, graph.adjacent);
+    write_block(out, dict.arena);
+    if (!out) {
+        throw runtime_error("Cannot write word graph file: " + filename);
+    }
+}
+
+bool is_word_graph_snapshot(const string& filename) {
+    ifstream in(filename, ios::binary);
+    char magic[sizeof(WORD_GRAPH_MAGIC)];
+    return in.read(magic, sizeof(magic)) && memcmp(magic, WORD_GRAPH_MAGIC, sizeof(magic)) == 0;
+}
+
+// Copies count elements starting at *at into block and advances *at.
+template <typename T>
+static void read_block(const char*& at, uint64_t count, vector<T>& block) {
+    block.resize(count);
+    memcpy(block.data(), at, count * sizeof(T));
+    at += count * sizeof(T);
+}
+
+void read_word_graph(WordGraph& graph, const string& filename) {
+    MappedFile file(filename, "word graph snapshot");
+    WordGraphHeader header;
+    if (file.size() < sizeof(header)) {
+        throw runtime_error(filename + ": truncated word graph header");
+    }
+    memcpy(&header, file.data(), sizeof(header));
+    if (memcmp(header.magic, WORD_GRAPH_MAGIC, sizeof(header.magic)) != 0) {
+        throw runtime_error(filename + ": not a word graph file");
+    }
+    if (header.version != WORD_GRAPH_VERSION) {
+        throw runtime_error(filename + ": unsupported word graph version " + to_string(header.version));
+    }
+    const uint64_t limit = numeric_limits<int>::max();
+    if (header.words >= limit || header.arenaBytes > numeric_limits<uint32_t>::max() || header.lengthGroups < 1
+        || header.lengthGroups > limit || header.tableSlots > limit || header.edges > limit) {
+        throw runtime_error(filename + ": word graph too large");
+    }
+    uint64_t expected = sizeof(header) + (header.words + 1 + header.lengthGroups + header.tableSlots) * sizeof(uint32_t)
+        + (header.words + 1 + header.edges) * sizeof(int) + header.arenaBytes;
+    if (file.size() != expected) {
+        throw runtime_error(filename + ": word graph size does not match its header");
+    }
+
+    WordGraph loaded;
+    Dictionary& dict = loaded.dict;
+    const char* at = file.data() + sizeof(header);
+    read_block(at, header.words + 1, dict.offsets);
+    read_block(at, header.lengthGroups, dict.length_begin);
+    read_block(at, header.tableSlots, dict.table);
+    read_block(at, header.words + 1, loaded.offsets);
+    read_block(at, header.edges, loaded.adjacent);
+    read_block(at, header.arenaBytes, dict.arena);
+
+    // Structural checks, so a corrupt file cannot send a lookup or a search
+    // out of bounds.
+    const int n = header.words;
+    auto corrupt = [&](const string& block) {
+        return runtime_error(filename + ": corrupt " + block + " block");
+    };
+    if (dict.offsets[0] != 0 || dict.offsets[n] != header.arenaBytes || !is_sorted(dict.offsets.begin(), dict.offsets.end())) {
+        throw corrupt("offsets");
+    }
+    // The batch kernels read whole length groups as packed blocks, so every
+    // word must really have its group's length.
+    if (dict.length_begin[0] != 0 || dict.length_begin.back() != static_cast<uint32_t>(n)
+        || !is_sorted(dict.length_begin.begin(), dict.length_begin.end())) {
+        throw corrupt("length");
+    }
+    for (int len = 0; len + 1 < static_cast<int>(dict.length_begin.size()); ++len) {
+        for (uint32_t id = dict.length_begin[len]; id < dict.length_begin[len + 1]; ++id) {
+            if (dict.offsets[id + 1] - dict.offsets[id] != static_cast<uint32_t>(len)) {
+                throw corrupt("length");
+            }
+        }
+    }
+    // Probing stops at an empty slot, so there must be one.
+    size_t used = 0;
+    for (uint32_t slot : dict.table) {
+        if (slot > static_cast<uint32_t>(n)) {
+            throw corrupt("table");
+        }
+        used += slot != 0;
+    }
+    if ((dict.table.size() & (dict.table.size() - 1)) != 0 || (!dict.table.empty() && used == dict.table.size())) {
+        throw corrupt("table");
+    }
+    if (loaded.offsets[0] != 0 || loaded.offsets[n] != static_cast<int>(header.edges)
+        || !is_sorted(loaded.offsets.begin(), loaded.offsets.end())) {
+        throw corrupt("adjacency");
+    }
+    for (int id : loaded.adjacent) {
+        if (static_cast<unsigned>(id) >= static_cast<unsigned>(n)) {
+            throw corrupt("adjacency");
+        }
+    }
+
+    graph = std::move(loaded);
+}
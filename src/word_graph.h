@@ -0,0 +1,82 @@
+#ifndef WORD_GRAPH_H
+#define WORD_GRAPH_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <set>
+#include <span>
+#include <cstdint>
+
+#include "dictionary.h"
+
+using namespace std;
+
+// Adjacency index over a dictionary: two words are neighbors when is_adjacent
+// holds. Built once by bucketing words on wildcard patterns ("c*t" for
+// substitutions, one-letter deletions for insertions) and frozen into CSR
+// arrays, so a search only touches real neighbors instead of scanning the
+// whole word list.
+struct WordGraph {
+    Dictionary dict;
+    vector<int> offsets;
+    vector<int> adjacent;
+
+    WordGraph() : offsets(1, 0) {}
+    explicit WordGraph(const set<string>& word_list);
+    explicit WordGraph(Dictionary dictionary);
+
+    int size() const {
+        return dict.size();
+    }
+
+    string_view word(int id) const {
+        return dict.word(id);
+    }
+
+    int find(string_view word) const {
+        return dict.find(word);
+    }
+
+    span<const int> neighbors(int id) const {
+        return span<const int>(adjacent.data() + offsets[id], offsets[id + 1] - offsets[id]);
+    }
+
+    // Neighbors of an arbitrary word, which need not be in the dictionary.
+    // Returned in ascending ID order. When comparisons is given, the number
+    // of candidate words checked is added to it.
+    vector<int> neighbors_of(string_view word, long long* comparisons = nullptr) const;
+};
+
+// Prebuilt WordGraph snapshot, little-endian, every block 4-byte aligned:
+//   header        magic "HW9WORDS", uint32 version, uint32 reserved, then
+//                 uint64 counts of words n, arena bytes, length groups,
+//                 hash slots and edges m
+//   offsets       uint32[n + 1], word starts in the arena
+//   length_begin  uint32[length groups]
+//   table         uint32[hash slots], Dictionary's lookup table
+//   adjacency     int32[n + 1] CSR row starts, then int32[m] neighbor IDs
+//   arena         char[arena bytes]
+// Reading is a fast load, not a zero-copy view: the file is mapped only
+// while each block is bulk-copied into the graph and checked, so no word is
+// hashed, sorted or compared. The graph owns its storage afterwards and the
+// file may change or disappear while it is in use.
+const char WORD_GRAPH_MAGIC[8] = {'H', 'W', '9', 'W', 'O', 'R', 'D', 'S'};
+const uint32_t WORD_GRAPH_VERSION = 1;
+
+struct WordGraphHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t words;
+    uint64_t arenaBytes;
+    uint64_t lengthGroups;
+    uint64_t tableSlots;
+    uint64_t edges;
+};
+
+void save_word_graph(const WordGraph& graph, const string& filename);
+bool is_word_graph_snapshot(const string& filename);
+void read_word_graph(WordGraph& graph, const string& filename);
+
+#endif // WORD_GRAPH_H